@@ -8,7 +8,7 @@
 *  Semester:         Fall 2024
 * 
 *  Description:
-*        This program defines a class that processes pairs of fractions from a file
+*        This program uses a class that processes pairs of fractions from a file
 *        and performs various mathematical operations such as addition, subtraction,
 *        multiplication, division, and equality comparison. It utilizes overloaded
 *        operators in some functions, with many of them computing the least common
@@ -18,388 +18,392 @@
 *  Usage:
 *       - $ ./P01 < input
 *       - This will read in a file named "input" containing fractions along with their operative values.
+*       - $ ./P01 --batch [--threads N] < input
+*       - Streams a large input file through a pool of worker threads. Output is identical.
+*       - Lines may be full expressions such as "(1/2 + 3/4) * 5/6 - 7/8".
+*       - $ ./P01 --batch --cache 64 < input
+*       - Caches the results of repeated lines in about 64 MB and prints hit/miss counts to stderr.
+*       - $ ./P01 --binary < jobs.bin > results.bin
+*       - Runs a binary job file (see fraction_record.hpp and fraction_convert.cpp) without parsing text.
+*       - $ ./P01 --serve /tmp/p01.sock [--threads N] &
+*       - Keeps running and answers clients on a Unix socket (see fraction_client.cpp). Ctrl-C stops it.
+*       - Build with -DFRACTION_STATS to print operation counts and stage timings as JSON at exit.
 * 
 *  Files:            
-*       P01.cpp     : driver program 
-*       input       : input file with fraction data set
+*       P01.cpp         : driver program 
+*       fraction.hpp    : Fraction class template with checked arithmetic
+*       batch.hpp       : streaming multithreaded batch evaluator
+*       fraction_parser.hpp : zero allocation "a/b op c/d" tokenizer
+*       expression.hpp  : expression compiler with parentheses and precedence
+*       output_buffer.hpp : buffered to_chars output writer
+*       fraction_record.hpp : packed binary job and result records
+*       fraction_server.hpp : Unix socket server for many clients at once
+*       int_math.hpp    : binary and Euclid GCD kernels, overflow-safe LCM
+*       fraction_stats.hpp : optional counters and stage timers (-DFRACTION_STATS)
+*       thread_pool.hpp : fixed size worker thread pool
+*       input           : input file with fraction data set
 *****************************************************************************/
 
+#include "batch.hpp"
+#include "expression.hpp"
+#include "fraction.hpp"
+#include "fraction_parser.hpp"
+#include "fraction_record.hpp"
+#include "fraction_server.hpp"
+#include "output_buffer.hpp"
+#include <algorithm>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
 
 using namespace std;
 
+size_t cacheBytes = 0;                          // cacheBytes is the result cache limit per thread, 0 when --cache is not used
+mutex cacheLock;                                // cacheLock guards liveCounters and finishedCounters
+vector<const CacheCounters*> liveCounters;      // liveCounters points at the cache counters of every running thread
+CacheCounters finishedCounters = {0, 0, 0};     // finishedCounters holds the totals of threads that already exited
+
+void addCounters(CacheCounters& total, const CacheCounters& counters) {
+        total.hits += counters.hits;
+        total.misses += counters.misses;
+        total.evictions += counters.evictions;
+}
+
 /**
- * Fraction
+ * CacheRegistration
  *
  * Description:
- *      This class represents a mathematical fraction and supports basic arithmetic operations
- *      such as addition, subtraction, multiplication, and division. It also supports comparison
- *      for equality. The class uses overloaded operators to perform these operations and provides
- *      methods for accessing the numerator and denominator of the fraction.
- *
- * Public Methods:
- *                           Fraction(int num, int den)
- *                           Fraction()
- *      int                  getDenominator()
- *      int                  getNumerator()
- *      Fraction             operator+(const Fraction& other)
- *      Fraction             operator-(const Fraction& other)
- *      Fraction             operator*(const Fraction& other)
- *      Fraction             operator/(const Fraction& other)
- *      bool                 operator==(Fraction& other)
- *      friend std::ostream& operator<<(std::ostream& os, const Fraction& frac)
- *
- * Private Methods:
- *      int                  gcd(int a, int b)
- *      int                  lcm(int a, int b)
- *
- * Usage (Within Main):
- *
- *      Fraction f1(1, 2);                           // Create a Fraction object with numerator 1 and denominator 2
- *      Fraction f2(3, 4);                           // Create another Fraction object with numerator 3 and denominator 4
- *
- *      Fraction sum = f1 + f2;                      // Add fractions
- *      Fraction diff = f1 - f2;                     // Subtract fractions
- *      Fraction prod = f1 * f2;                     // Multiply fractions
- *      Fraction quot = f1 / f2;                     // Divide fractions
- *      bool equal = (f1 == f2);                     // Compare fractions for equality
- *      
- *      cout << f1 << " + " << f2 << " = " << sum;   // Output the result of addition
- *
- * Notes:
- *      - If the denominator is initialized to 0, it will be adjusted to 1.
- *      - The equality operator compares fractions by adjusting their numerators to a common denominator.
+ *      Lists one thread's cache counters in liveCounters while the thread
+ *      runs, and folds them into finishedCounters when the thread exits
+ *      (batch worker threads finish before main prints the summary).
  */
+struct CacheRegistration {
+    const CacheCounters* counters;          // Counters of this thread's cache, or null
 
-class Fraction {
-private:
-    int numerator;                                 //numerator is a private integer for storing the numerator of each fraction
-    int denominator;                               //denominator is the same idea but for the denominator
-
-/**
-*Private : gcd
-*
-* Description:
-*      Computes the Greatest Common Divisor (GCD) of two integers.
-*
-* Params:
-*      int a  : First integer
-*      int b  : Second integer
-*
-* Returns:
-*      int   : The GCD of the two integers.
-*/
-    int gcd(int, int);
-
-/**
-* Private : lcm
-*
-* Description:
-*      Computes the Least Common Multiple (LCM) of two integers.
-*
-* Params:
-*      int a  : First integer
-*      int b  : Second integer
-*
-* Returns:
-*      int   : The LCM of the two integers.
-*/
-    int lcm(int, int);
-
-public:
+    CacheRegistration() : counters(nullptr) {}
 
-/**
-* Public : Fraction (Constructor)
-*
-* Description:
-*      Constructs a Fraction object with the given numerator and denominator.
-*      If the denominator is zero, it will be set to one, and a warning message will be displayed.
-*
-* Params:
-*      int num  : Numerator of the fraction
-*      int den  : Denominator of the fraction
-*/
-    Fraction(int num, int den) : numerator(num), denominator(den) {
-        if(den == 0)
-        {
-            cout << "You cannot divide by 0. The denominator will be set to 1.\n";
-            denominator = 1;
-        }
-    }
-    
-/**
-* Public : Fraction (Default Constructor)
-*
-* Description:
-*      Constructs a Fraction object with default values of numerator and denominator set to 1.
-*/    
-    Fraction(){
-        numerator = 1;
-        denominator = 1;
-    }
-    
-/**
-* Public : getDenominator
-*
-* Description:
-*      Returns the denominator of the fraction.
-*
-* Returns:
-*      int   : The denominator of the fraction.
-*/
-    int getDenominator(){
-        return denominator;
+    void add(const CacheCounters* c) {
+        lock_guard<mutex> guard(cacheLock);
+        counters = c;
+        liveCounters.push_back(c);
     }
 
- /**
-* Public : getNumerator
-*
-* Description:
-*      Returns the numerator of the fraction.
-*
-* Returns:
-*      int   : The numerator of the fraction.
-*/   
-     int getNumerator(){
-        return numerator;
+    ~CacheRegistration() {
+        if (counters != nullptr) {
+            lock_guard<mutex> guard(cacheLock);
+            addCounters(finishedCounters, *counters);
+            liveCounters.erase(find(liveCounters.begin(), liveCounters.end(), counters));
+        }
     }
-    
-// friend std::ostream& operator<<(std::ostream& os, const Fraction& frac);
-
-
+};
 
 /**
-* Public : operator+
-*
-* Description:
-*      Adds two Fraction objects and returns the result as a new Fraction object.
-*
-* Params:
-*      const Fraction& other : The fraction to be added to the current fraction.
-*
-* Returns:
-*      Fraction : The result of the addition.
-*/
-    Fraction operator+(const Fraction& other);
+ * threadEngine
+ *
+ * Description:
+ *      Returns this thread's ExpressionEngine for integer type T. The first
+ *      call on a thread turns on its result cache when --cache was given and
+ *      registers the cache's counters for the summary printed by main.
+ *
+ * Returns:
+ *      ExpressionEngine<T>& : Engine owned by the calling thread
+ */
+template <typename T>
+ExpressionEngine<T>& threadEngine() {
+        static thread_local ExpressionEngine<T> engine;     // engine caches compiled expressions for this thread
+        static thread_local CacheRegistration registration; // declared after engine, so it is destroyed first
+        static thread_local bool ready = false;
+        if (!ready) {
+            ready = true;
+            if (cacheBytes > 0) {
+                engine.enableResultCache(cacheBytes);
+                registration.add(engine.getCacheCounters());
+            }
+        }
+        return engine;
+}
 
 /**
-* Public : operator-
-*
-* Description:
-*      Subtracts one Fraction object from another and returns the result as a new Fraction object.
-*
-* Params:
-*      const Fraction& other : The fraction to be subtracted from the current fraction.
-*
-* Returns:
-*      Fraction : The result of the subtraction.
-*/
-    Fraction operator-(const Fraction& other);
+ * printCacheSummary
+ *
+ * Description:
+ *      Writes the total result cache hits, misses and evictions of every
+ *      thread to standard error, so standard output stays the same with or
+ *      without the cache.
+ *
+ * Returns:
+ *      void
+ */
+void printCacheSummary() {
+        lock_guard<mutex> guard(cacheLock);
+        CacheCounters total = finishedCounters; // total adds up the counters of every thread
+        for (const CacheCounters* counters : liveCounters) {
+            addCounters(total, *counters);
+        }
+        uint64_t lookups = total.hits + total.misses;
+        cerr << "Result cache: " << total.hits << " hits, " << total.misses << " misses, "
+             << total.evictions << " evictions";
+        if (lookups > 0) {
+            cerr << " (" << total.hits * 100 / lookups << "% hit rate)";
+        }
+        cerr << "\n";
+}
 
 /**
-* Public : operator*
-*
-* Description:
-*      Multiplies two Fraction objects and returns the result as a new Fraction object.
-*
-* Params:
-*      const Fraction& other : The fraction to be multiplied with the current fraction.
-*
-* Returns:
-*      Fraction : The result of the multiplication.
-*/
-    Fraction operator*(const Fraction& other);
+ * evaluateLine
+ *
+ * Description:
+ *      Evaluates one line of input using T as the integer type. The line may
+ *      be any expression ExpressionEngine accepts, from "1/2 + 3/4" to
+ *      "(1/2 + 3/4) * 5/6 - 7/8" or "a == b". The line is echoed and then
+ *      its result is written. Blank lines are skipped and lines that do not
+ *      parse produce an error message with the line and column of the
+ *      problem. The serial loop and the batch workers both go through here
+ *      so they always produce the same output. Each thread keeps its own
+ *      engine, so a shape like "n+n" is compiled once per thread.
+ *
+ * Params:
+ *      const char* begin : First character of the line
+ *      const char* end   : One past the last character of the line
+ *      size_t line       : Line number used in error messages
+ *      OutputBuffer& out : Buffer the echo and result are written to
+ *
+ * Returns:
+ *      void
+ */
+template <typename T>
+void evaluateLine(const char* begin, const char* end, size_t line, OutputBuffer& out) {
+        ExpressionEngine<T>& engine = threadEngine<T>();    // engine caches compiled expressions (and results with --cache) for this thread
+        FractionParser parser(begin, end, line);
+        if (parser.atEnd()) {
+            return;
+        }
+        ExpressionResult<T> result;             // result holds the value or status of the expression
+        if (!engine.evaluate(begin, end, line, result)) {
+            out << engine.getError() << "\n";
+            return;
+        }
+        FRACTION_STAGE(StatStage::Format);
+        while (*begin == ' ' || *begin == '\t') {
+            ++begin;
+        }
+        while (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r') {
+            --end;
+        }
+        out << string_view(begin, end - begin) << '\n';
+        if (result.zeroDenominator) {
+            out << "You cannot divide by 0. The denominator will be set to 1.\n";
+        }
 
-/**
-* Public : operator/
-*
-* Description:
-*      Divides one Fraction object by another and returns the result as a new Fraction object.
-*
-* Params:
-*      const Fraction& other : The fraction to divide the current fraction by.
-*
-* Returns:
-*      Fraction : The result of the division.
-*/
-    Fraction operator/(const Fraction& other);
-    
-/**
-* Public : operator==
-*
-* Description:
-*      Compares two Fraction objects for equality.
-*
-* Params:
-*      Fraction& other : The fraction to compare with the current fraction.
-*
-* Returns:
-*      bool   : True if the fractions are equal, false otherwise.
-*/
-    bool operator==(Fraction& other);
+        if(result.status == FractionStatus::DivideByZero){
+            out << "Error: Division by zero.\n";
+        }
+        else if(result.status == FractionStatus::Overflow){
+            out << "Error: Result does not fit in " << sizeof(T) * 8 << " bit integers.\n";
+        }
+        else if(result.comparison){
+            if(result.equal == true){
+                out << "The fractions are equal. \n";
+            }
+            else
+                out << "The fractions are not equal. \n";
+        }
+        else{
+            out << result.value << "\n";
+        }
+}
 
 /**
-* Public : operator<< (Friend Function)
-*
-* Description:
-*      Overloads the output stream operator to allow printing of Fraction objects.
-*
-* Params:
-*      std::ostream& os : The output stream.
-*      const Fraction& frac : The fraction to be printed.
-*
-* Returns:
-*      std::ostream& : The updated output stream.
-*/
-    friend ostream& operator<<(ostream& os, const Fraction& frac);
-
-};
-
- // Overloaded addition operator
-    Fraction Fraction::operator+(const Fraction& other) {
-    int commonDenominator = lcm(denominator, other.denominator);                            //commonDenominator is created to store the result of the lcm of the two denominators as an integer
-
-    int adjustedNumerator1 = numerator * (commonDenominator / denominator);                 //adjustedNumerator1 and AdjustedNumerator2 are created to adjust both fractions to the same denominator
-    int adjustedNumerator2 = other.numerator * (commonDenominator / other.denominator);
-
-    int resultNumerator = adjustedNumerator1 + adjustedNumerator2;                          //resultNumerator and resultDenominator are created to hold the full values that will go on to be checked for simplification
-    int resultDenominator = commonDenominator;
-
-    int divisor = gcd(resultNumerator, resultDenominator);                                  //divisor is created to call on the gcd and then is used to simplify the result
-    resultNumerator /= divisor;
-    resultDenominator /= divisor;
-
-    return Fraction(resultNumerator, resultDenominator);
-    }
-
-    // Overloaded subtraction operator
-    Fraction Fraction::operator-(const Fraction& other) {
-    int commonDenominator = lcm(denominator, other.denominator);                            //commonDenominator is created to store the result of the lcm of the two denominators as an integer
-
-    int adjustedNumerator1 = numerator * (commonDenominator / denominator);                 //adjustedNumerator1 and AdjustedNumerator2 are created to adjust both fractions to the same denominator
-    int adjustedNumerator2 = other.numerator * (commonDenominator / other.denominator);
-
-    int resultNumerator = adjustedNumerator1 - adjustedNumerator2;                          //resultNumerator and resultDenominator are created to hold the full values that will go on to be checked for simplification
-    int resultDenominator = commonDenominator;
-
-    int divisor = gcd(resultNumerator, resultDenominator);                                  //divisor is created to call on the gcd and then is used to simplify the result
-    resultNumerator /= divisor;
-    resultDenominator /= divisor;
-
-    return Fraction(resultNumerator, resultDenominator);
-    }
-
-    // Overloaded multiplication operator
-    Fraction Fraction::operator*(const Fraction& other) {
-    int resultNumerator = numerator * other.numerator;                                       //resultNumerator is created as an integer that stores the numerators of both fractions multiplied
-    
-    int resultDenominator = denominator * other.denominator;                                 //resultDenominator is created as an integer that stores the denominators of both fractions multiplied
-    
-    int divisor = gcd(resultNumerator, resultDenominator);                                   //divisor is created to call on the gcd and then is used to simplify the result
-    resultNumerator /= divisor;
-    resultDenominator /= divisor;
-    
-    return Fraction(resultNumerator, resultDenominator);
-    }
-
-    // Overloaded division operator
-    Fraction Fraction::operator/(const Fraction& other) {
-    int resultNumerator = numerator * other.denominator;                                     //resultNumerator is created as an integer that stores the numerators of both fractions multiplied
-    
-    int resultDenominator = denominator * other.numerator;                                   //resultDenominator is created as an integer that stores the denominators of both fractions multiplied
-    
-    int divisor = gcd(resultNumerator, resultDenominator);                                   //divisor is created to call on the gcd and then is used to simplify the result
-    resultNumerator /= divisor;
-    resultDenominator /= divisor;
-    
-    if (resultDenominator == 0) {
-        cout << "Error: Division by zero.\n";
-        return Fraction(0, 1);                                                              //returns a default fraction to handle this case
-    }
-    
-    return Fraction(resultNumerator, resultDenominator);
-    }
-
-    // Overloaded equality operator (==)
-    bool Fraction::operator==(Fraction& other) {
-
-    int commonDenominator = lcm(denominator, other.denominator);                            //commonDenominator finds the least common multiple of both denominators
-    
-    int adjustedNumerator1 = numerator * (commonDenominator / denominator);                 //adjustedNumerator1 modifies the numerator to the possible common denominator
-    int adjustedNumerator2 = other.numerator * (commonDenominator / other.denominator);     //the same logic but for the other numerator inside adjustedNumerator2
-
-    return adjustedNumerator1 == adjustedNumerator2;
-    }
+ * runBinary
+ *
+ * Description:
+ *      Reads packed job records (see fraction_record.hpp) from standard
+ *      input, through mmap() when stdin is a file, and writes packed result
+ *      records to standard output. No text is parsed or formatted.
+ *
+ * Returns:
+ *      int : Exit code (1 if the input is not a job file)
+ */
+int runBinary() {
+        MappedFile input(STDIN_FILENO);         // input is the whole job file, mapped in place when possible
+        RecordHeader header;
+        if (!readHeader(input.data(), input.size(), header) || header.kind != RecordKind::Jobs) {
+            cerr << "Error: standard input is not a binary job file.\n";
+            return 1;
+        }
+        size_t count = (input.size() - recordHeaderSize) / jobRecordSize;
+        if (recordHeaderSize + count * jobRecordSize != input.size()) {
+            cerr << "Warning: ignoring a partial record at the end of the input.\n";
+        }
 
+        OutputBuffer out(1 << 20);              // out collects result records and is written in large blocks
+        char packed[recordHeaderSize > resultRecordSize ? recordHeaderSize : resultRecordSize];
+        writeHeader(packed, RecordKind::Results);
+        out << string_view(packed, recordHeaderSize);
+        const char* record = input.data() + recordHeaderSize;
+        for (size_t i = 0; i < count; i++, record += jobRecordSize) {
+            encodeResult(packed, evaluateRecord(decodeJob(record)));
+            out << string_view(packed, resultRecordSize);
+            if (out.size() >= (1 << 20)) {
+                out.writeTo(STDOUT_FILENO);
+            }
+        }
+        out.writeTo(STDOUT_FILENO);
+        return 0;
+}
 
-    // Overload output operator (<<) for printing fractions
-    ostream& operator<<(std::ostream& os, const Fraction& frac) {
-        os << frac.numerator << "/" << frac.denominator;
-        return os;
-    }
+FractionServer* activeServer = nullptr;         // activeServer is the running --serve server, stopped by SIGINT and SIGTERM
 
-    // Function to calculate Greatest Common Divisor (GCD)
-    int Fraction::gcd(int a, int b) {
-    while (b != 0) {
-        int temp = b;
-        b = a % b;
-        a = temp;
-    }
-    return a;
-    }
+void stopServer(int) {
+        if (activeServer != nullptr) {
+            activeServer->stop();
+        }
+}
 
-    // Function to calculate Least Common Multiple (LCM)
-    int Fraction::lcm(int a, int b) {
-    return (a * b) / gcd(a, b);
-    }
+/**
+ * runServer
+ *
+ * Description:
+ *      Serves clients on a Unix domain socket until SIGINT or SIGTERM,
+ *      then prints how many clients and lines were handled to stderr.
+ *
+ * Params:
+ *      const string& path                 : Socket file to create
+ *      BatchEvaluator::LineHandler handler : Line evaluator for the chosen width
+ *      size_t threads                     : Worker threads shared by all clients
+ *
+ * Returns:
+ *      int : Exit code (1 if the socket could not be created)
+ */
+int runServer(const string& path, BatchEvaluator::LineHandler handler, size_t threads) {
+        FractionServer server(handler, threads);
+        if (!server.listen(path)) {
+            cerr << "Error: " << server.getError() << "\n";
+            return 1;
+        }
+        activeServer = &server;
+        signal(SIGINT, stopServer);
+        signal(SIGTERM, stopServer);
+        cerr << "Listening on " << path << "\n";
+        server.run();
+        activeServer = nullptr;
+        cerr << server.getClientCount() << " clients, " << server.getLineCount() << " lines\n";
+        return 0;
+}
 
+/**
+ * Main
+ *
+ * Description:
+ *      Reads fraction expressions from standard input, one per line, and
+ *      prints each one with its result. With --batch the input is streamed in large blocks and
+ *      evaluated on a pool of worker threads instead, which is much faster for
+ *      big files and gives the same output.
+ *
+ * Params:
+ *      --batch       : Use the multithreaded batch evaluator
+ *      --threads N   : Number of batch worker threads (default: one per core)
+ *      --width W     : Integer width in bits, 32, 64 (default) or 128
+ *      --cache MB    : Cache results of repeated lines in about MB megabytes
+ *      --binary      : Read binary job records and write binary results (64 bit only)
+ *      --serve PATH  : Keep running and answer clients on the Unix socket PATH
+ *
+ * Returns:
+ *      int : Exit code (0 for success)
+ */
 int main(int argc, char *argv[]) {
 
-        int n1, d1, n2, d2;                     // Four integers are created to allow for the two denominators and two numerators to be read in through the string and then stored
-        string s1, op, s2;                      // Three strings are created, two for saving the two fractions as a whole entity, and one for saving and determining the operator being used
-        while(cin >> s1 >> op >> s2)
-        {
-            cout<<s1<<" "<<op<<" "<<s2<<endl;
-            n1 = s1[0] - '0';
-            d1 = s1[2] - '0';
-            n2 = s2[0] - '0';
-            d2 = s2[2] - '0';
-            Fraction f1(n1, d1);                //f1 is the stored information of the first fraction's numerator and denominator
-            Fraction f2(n2, d2);                //f2 is the stored information of the second fraction's numerator and denominator
-
-            if(op == "+"){
-                // cout<<"+"<<endl;
-                Fraction ans = f1 + f2;         // Fraction 'ans' holds the result of f1 and f2's overloaded addition
-                cout << ans << endl;
-            }
-            else if(op == "-"){
-                // cout<<"-"<<endl;
-                Fraction ans = f1 - f2;         // Fraction 'ans' holds the result of f1 and f2's overloaded subtraction
-                cout << ans << endl;
+        bool batch = false;                     // batch is set when --batch is passed on the command line
+        bool binary = false;                    // binary is set when --binary is passed on the command line
+        string servePath;                       // servePath is the socket given with --serve, empty otherwise
+        size_t threads = 0;                     // threads is the worker count for batch mode, 0 meaning one per core
+        int width = 64;                         // width is the integer size in bits every fraction is stored in
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "--batch") {
+                batch = true;
+            } else if (arg == "--binary") {
+                binary = true;
+            } else if (arg == "--threads" && i + 1 < argc) {
+                threads = strtoul(argv[++i], nullptr, 10);
+            } else if (arg == "--cache" && i + 1 < argc) {
+                cacheBytes = strtoul(argv[++i], nullptr, 10) << 20;
+            } else if (arg == "--serve" && i + 1 < argc) {
+                servePath = argv[++i];
+            } else if (arg == "--width" && i + 1 < argc) {
+                width = atoi(argv[++i]);
+            } else {
+                width = 0;
+                break;
             }
-            else if(op == "*"){
-                // cout<<"*"<<endl;
-                Fraction ans = f1 * f2;         // Fraction 'ans' holds the result of f1 and f2's overloaded multiplication
-                cout << ans << endl;
+        }
+
+        BatchEvaluator::LineHandler handler;    // handler is evaluateLine for the chosen integer width
+        if (binary && width == 64) {
+            return runBinary();
+        } else if (binary) {
+            width = 0;                          // binary records are always 64 bit
+        }
+        if (width == 32) {
+            handler = evaluateLine<int32_t>;
+        } else if (width == 64) {
+            handler = evaluateLine<int64_t>;
+#ifdef __SIZEOF_INT128__
+        } else if (width == 128) {
+            handler = evaluateLine<__int128>;
+#endif
+        } else {
+            cerr << "Usage: " << argv[0] << " [--batch] [--threads N] [--width 32|64|128] [--cache MB] [--binary] [--serve PATH] < input\n";
+            return 1;
+        }
+
+        ios::sync_with_stdio(false);
+        if (!servePath.empty()) {
+            size_t workers = threads == 0 ? ThreadPool::defaultThreads() : threads;
+            cacheBytes /= workers;
+            int status = runServer(servePath, handler, workers);
+            if (cacheBytes > 0) {
+                printCacheSummary();
             }
-            else if(op == "/"){
-                // cout<<"/"<<endl;
-                Fraction ans = f1 / f2;         // Fraction 'ans' holds the result of f1 and f2's overloaded division
-                cout << ans << endl;
+            return status;
+        }
+        if (batch) {
+            size_t workers = threads == 0 ? ThreadPool::defaultThreads() : threads;
+            cacheBytes /= workers;              // every worker thread has its own cache, so split the limit between them
+            BatchEvaluator evaluator(handler, threads);
+            evaluator.run(stdin, stdout);
+            if (cacheBytes > 0) {
+                printCacheSummary();
             }
-            else if(op == "=="){
-                // cout<<"=="<<endl;
-                bool ans = f1 == f2;            // Bool 'ans' holds the result of f1 and f2's overloaded equality check
-                if(ans == true){
-                    cout << "The fractions are equal. \n";
-                }
-                else
-                    cout << "The fractions are not equal. \n";
+            return 0;
+        }
+
+        string input;                           // input holds one line at a time, which the parser reads in place
+        size_t line = 0;                        // line counts lines so parse errors can say where they happened
+        bool interactive = isatty(STDIN_FILENO);    // interactive input gets its answer after every line
+        OutputBuffer out(1 << 16);              // out collects results and is written with one write() call at a time
+        while(true)
+        {
+            {
+                FRACTION_STAGE(StatStage::Read);
+                if (!getline(cin, input)) {
+                    break;
                 }
-            else{
-                cout << "Operator not recognized. \n";
             }
+            handler(input.data(), input.data() + input.size(), ++line, out);
+            if (interactive || out.size() >= (1 << 16)) {
+                out.writeTo(STDOUT_FILENO);
+            }
+        }
+        out.writeTo(STDOUT_FILENO);
+        if (cacheBytes > 0) {
+            printCacheSummary();
         }
     return 0;
 }
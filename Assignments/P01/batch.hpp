@@ -0,0 +1,230 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            BatchEvaluator Class
+*  Title:            Streaming Multithreaded Batch Evaluator
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This class streams a large input file in big chunks, cuts each chunk
+*        at its last newline so no line is ever split, and hands the blocks to
+*        a pool of worker threads. Every block is evaluated line by line into
+*        its own OutputBuffer, and the buffers are written back out in the
+*        same order the blocks were read, one write() call per block, so the
+*        result matches the serial driver exactly.
+*
+*  Usage:
+*       - Create a BatchEvaluator with a per-line handler
+*       - Call run() with an input and output stream (stdin/stdout by default)
+*
+*  Files:
+*       batch.hpp       : header file containing the BatchEvaluator class
+*       thread_pool.hpp : worker pool used to evaluate blocks
+*       output_buffer.hpp : buffer each block's output is formatted into
+*****************************************************************************/
+
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include "fraction_stats.hpp"
+#include "output_buffer.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <utility>
+#include <vector>
+
+/**
+ * BatchEvaluator
+ *
+ * Description:
+ *      Reads input in chunks of chunkSize bytes, splits them into
+ *      line-aligned blocks and evaluates the blocks in parallel. At most
+ *      maxInFlight blocks are queued at once, so memory use stays bounded no
+ *      matter how large the input is.
+ *
+ * Public Methods:
+ *      BatchEvaluator(LineHandler h, size_t threads, size_t chunkSize)
+ *      void   run(FILE* in, FILE* out)          - Evaluates all of in into out
+ *      size_t getLineCount()                    - Lines handled by the last run
+ *      static std::pair<OutputBuffer, size_t> evaluateBlock(handler, data, size, firstLine)
+ *
+ * Usage:
+ *      BatchEvaluator batch(handler, 8);        // Eight worker threads
+ *      batch.run(stdin, stdout);                // Stream stdin to stdout
+ */
+class BatchEvaluator {
+public:
+    // Evaluates one line (without its newline) and writes the result to out.
+    // line is the 1-based line number of the line in the whole input.
+    typedef std::function<void(const char* begin, const char* end, size_t line, OutputBuffer& out)>
+        LineHandler;
+
+private:
+    LineHandler handler;        // Called once for every line of input
+    size_t threads;             // Number of worker threads
+    size_t chunkSize;           // Bytes read from the input per block
+    size_t maxInFlight;         // Blocks allowed to be queued at once
+    size_t lineCount;           // Lines handled by the last run
+
+public:
+    /**
+    * Constructor
+    *
+    * Params:
+    *      LineHandler h    : Function that evaluates a single line
+    *      size_t threads   : Worker thread count (0 means one per core)
+    *      size_t chunkSize : Bytes read per block (defaults to 4 MiB)
+    */
+    explicit BatchEvaluator(LineHandler h, size_t threads = 0, size_t chunkSize = 4 << 20)
+        : handler(std::move(h)),
+          threads(threads == 0 ? ThreadPool::defaultThreads() : threads),
+          chunkSize(chunkSize == 0 ? 1 : chunkSize),
+          maxInFlight(0),
+          lineCount(0) {
+        maxInFlight = this->threads * 2;
+    }
+
+    /**
+    * Public : run
+    *
+    * Description:
+    *      Streams all of in through the worker pool and writes the results
+    *      to out in input order. The calling thread does all of the reading
+    *      and writing, so the workers only ever see whole lines. Output goes
+    *      straight to out's file descriptor, one write() per block.
+    *
+    * Params:
+    *      FILE* in  : Stream to read expressions from
+    *      FILE* out : Stream to write results to
+    *
+    * Returns:
+    *      void
+    */
+    void run(FILE* in = stdin, FILE* out = stdout) {
+        ThreadPool pool(threads);
+        std::deque<std::future<std::pair<OutputBuffer, size_t> > > pending;
+        std::vector<char> carry;                // Partial line left over from the last read
+        size_t nextLine = 1;                    // Line number of the next block's first line
+        bool done = false;
+        lineCount = 0;
+        std::fflush(out);                       // Anything already buffered in out goes first
+        int outFd = fileno(out);
+
+        // Writes the oldest finished block so output stays in input order
+        auto flushFront = [&]() {
+            std::pair<OutputBuffer, size_t> result = pending.front().get();
+            pending.pop_front();
+            result.first.writeTo(outFd);
+            lineCount += result.second;
+        };
+
+        while (!done) {
+            std::vector<char> block;
+            block.swap(carry);
+            size_t have = block.size();
+            block.resize(have + chunkSize);
+            size_t got = 0;
+            {
+                FRACTION_STAGE(StatStage::Read);
+                got = std::fread(block.data() + have, 1, chunkSize, in);
+            }
+            block.resize(have + got);
+
+            if (got < chunkSize) {
+                done = true;                    // EOF or read error: flush whatever is left
+            } else {
+                // Hold back everything after the last newline for the next block
+                size_t cut = block.size();
+                while (cut > 0 && block[cut - 1] != '\n') {
+                    --cut;
+                }
+                if (cut > 0) {
+                    carry.assign(block.begin() + cut, block.end());
+                    block.resize(cut);
+                } else {
+                    carry.swap(block);          // One very long line: keep reading
+                    continue;
+                }
+            }
+            if (block.empty()) {
+                continue;
+            }
+
+            if (pending.size() >= maxInFlight) {
+                flushFront();
+            }
+            size_t firstLine = nextLine;
+            nextLine += std::count(block.begin(), block.end(), '\n');
+            std::shared_ptr<std::vector<char> > shared =
+                std::make_shared<std::vector<char> >(std::move(block));
+            pending.push_back(pool.submit([this, shared, firstLine] {
+                return evaluateBlock(handler, shared->data(), shared->size(), firstLine);
+            }));
+        }
+        while (!pending.empty()) {
+            flushFront();
+        }
+    }
+
+    /**
+    * Public : evaluateBlock
+    *
+    * Description:
+    *      Runs a handler over every line in a block. Blank lines are
+    *      skipped and a trailing carriage return is dropped. Static so other
+    *      front ends (the socket server) can evaluate blocks the same way.
+    *
+    * Params:
+    *      const LineHandler& handler : Function that evaluates a single line
+    *      const char* data           : Line-aligned chunk of input
+    *      size_t size                : Bytes in the chunk
+    *      size_t firstLine           : Line number of the block's first line
+    *
+    * Returns:
+    *      std::pair<OutputBuffer, size_t> : Block output and its line count
+    */
+    static std::pair<OutputBuffer, size_t> evaluateBlock(const LineHandler& handler, const char* data, size_t size,
+                                                         size_t firstLine) {
+        OutputBuffer out(size * 2);
+        size_t lines = 0;
+        size_t line = firstLine;
+        const char* p = data;
+        const char* end = p + size;
+        while (p < end) {
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (eol == nullptr) {
+                eol = end;
+            }
+            const char* last = eol;
+            if (last > p && last[-1] == '\r') {
+                --last;
+            }
+            if (last > p) {
+                handler(p, last, line, out);
+                ++lines;
+            }
+            ++line;
+            p = eol + 1;
+        }
+        return std::make_pair(std::move(out), lines);
+    }
+
+    /**
+    * Public : getLineCount
+    *
+    * Returns:
+    *      size_t : Number of non-blank lines handled by the last run
+    */
+    size_t getLineCount() const {
+        return lineCount;
+    }
+};
+
+#endif
@@ -0,0 +1,293 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            BigFraction Class
+*  Title:            Arbitrary Precision Fraction
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This class is an exact fraction that never overflows. While the
+*        numerator and denominator fit in 64 bits they are stored inline and
+*        every operation goes through the checked Fraction64 code, so small
+*        values never touch the allocator. Only when a checked operation
+*        reports overflow is the result computed with BigInt and moved to the
+*        heap, and it moves back inline as soon as it fits again.
+*
+*  Usage:
+*       - BigFraction sum;                        // 0/1
+*       - sum = sum + BigFraction(1, 3);
+*       - cout << sum;                            // prints every digit
+*
+*  Files:
+*       big_fraction.hpp : header file containing the BigFraction class
+*       big_int.hpp      : arbitrary precision integer used for large values
+*       fraction.hpp     : Fraction64 used for the inline fast path
+*****************************************************************************/
+
+#ifndef BIG_FRACTION_HPP
+#define BIG_FRACTION_HPP
+
+#include "big_int.hpp"
+#include "fraction.hpp"
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+/**
+ * BigFraction
+ *
+ * Description:
+ *      Reduced fraction with a positive denominator. Small values live in
+ *      two int64_t fields; large ones in a heap allocated pair of BigInts.
+ *      Copies of large values copy the BigInts.
+ *
+ * Public Methods:
+ *                           BigFraction(int64_t num, int64_t den)
+ *                           BigFraction()
+ *                           BigFraction(const Fraction64& frac)
+ *                           BigFraction(const BigInt& num, const BigInt& den)
+ *      bool                 isSmall()                 - True when stored inline
+ *      BigInt               getNumerator()
+ *      BigInt               getDenominator()
+ *      BigFraction          operator+(const BigFraction& other)
+ *      BigFraction          operator-(const BigFraction& other)
+ *      BigFraction          operator*(const BigFraction& other)
+ *      BigFraction          operator/(const BigFraction& other)
+ *      bool                 operator==(const BigFraction& other)
+ *      friend std::ostream& operator<<(std::ostream& os, const BigFraction& frac)
+ *
+ * Private Methods:
+ *      void                 assign(BigInt num, BigInt den)  - Reduce, then store inline if it fits
+ *
+ * Usage:
+ *      BigFraction total(0, 1);
+ *      for (int i = 1; i <= 100; i++)
+ *          total = total + BigFraction(1, i);   // exact harmonic number
+ *      cout << total;
+ *
+ * Notes:
+ *      - If the denominator is initialized to 0, it will be adjusted to 1.
+ *      - Dividing by a zero fraction prints an error and returns 0/1, like Fraction.
+ */
+class BigFraction {
+    struct Parts {
+        BigInt numerator;
+        BigInt denominator;
+    };
+
+    int64_t numerator;                  // Inline numerator, valid when big is null
+    int64_t denominator;                // Inline denominator, valid when big is null
+    std::unique_ptr<Parts> big;         // Heap storage, only for values that do not fit
+
+    Fraction64 small() const {
+        return Fraction64(numerator, denominator);
+    }
+
+    /**
+    * Private : assign
+    *
+    * Description:
+    *      Stores num/den in lowest terms with a positive denominator, inline
+    *      if both parts fit in 64 bits and on the heap otherwise.
+    */
+    void assign(BigInt num, BigInt den) {
+        BigInt g = BigInt::gcd(num, den);
+        if (!g.isZero() && g != BigInt(1)) {
+            num = num / g;
+            den = den / g;
+        }
+        if (den.isNegative()) {
+            num = -num;
+            den = -den;
+        }
+        if (num.fitsInt64() && den.fitsInt64()) {
+            numerator = num.toInt64();
+            denominator = den.toInt64();
+            big.reset();
+        } else {
+            if (!big) {
+                big.reset(new Parts);
+            }
+            big->numerator = std::move(num);
+            big->denominator = std::move(den);
+        }
+    }
+
+    void assign(const Fraction64& frac) {
+        numerator = frac.getNumerator();
+        denominator = frac.getDenominator();
+        big.reset();
+    }
+
+public:
+    /**
+    * Public : BigFraction (Constructor)
+    *
+    * Description:
+    *      Constructs a reduced fraction. If the denominator is zero, it will
+    *      be set to one, and a warning message will be displayed.
+    *
+    * Params:
+    *      int64_t num  : Numerator of the fraction
+    *      int64_t den  : Denominator of the fraction
+    */
+    BigFraction(int64_t num, int64_t den) : numerator(0), denominator(1) {
+        if (den == 0) {
+            std::cout << "You cannot divide by 0. The denominator will be set to 1.\n";
+            den = 1;
+        }
+        Fraction64 reduced;
+        if (Fraction64(num, den).checkedMul(Fraction64(1, 1), reduced) == FractionStatus::Ok) {
+            assign(reduced);
+        } else {
+            assign(BigInt(num), BigInt(den));          // only INT64_MIN over a negative denominator gets here
+        }
+    }
+
+    BigFraction() : numerator(0), denominator(1) {}
+
+    BigFraction(const Fraction64& frac) : BigFraction(frac.getNumerator(), frac.getDenominator()) {}
+
+    BigFraction(const BigInt& num, const BigInt& den) : numerator(0), denominator(1) {
+        if (den.isZero()) {
+            std::cout << "You cannot divide by 0. The denominator will be set to 1.\n";
+            assign(num, BigInt(1));
+        } else {
+            assign(num, den);
+        }
+    }
+
+    BigFraction(const BigFraction& other)
+        : numerator(other.numerator), denominator(other.denominator),
+          big(other.big ? new Parts(*other.big) : nullptr) {}
+
+    BigFraction(BigFraction&& other) = default;
+
+    BigFraction& operator=(const BigFraction& other) {
+        if (this != &other) {
+            numerator = other.numerator;
+            denominator = other.denominator;
+            big.reset(other.big ? new Parts(*other.big) : nullptr);
+        }
+        return *this;
+    }
+
+    BigFraction& operator=(BigFraction&& other) = default;
+
+    bool isSmall() const {
+        return !big;
+    }
+
+    BigInt getNumerator() const {
+        return big ? big->numerator : BigInt(numerator);
+    }
+
+    BigInt getDenominator() const {
+        return big ? big->denominator : BigInt(denominator);
+    }
+
+/**
+* Public : operator+ / operator- / operator* / operator/
+*
+* Description:
+*      Exact arithmetic. When both sides are inline the checked Fraction64
+*      operator is tried first and its result is kept if it did not
+*      overflow; otherwise the BigInt path runs.
+*
+* Params:
+*      const BigFraction& other : Right hand operand
+*
+* Returns:
+*      BigFraction : The reduced result
+*/
+    BigFraction operator+(const BigFraction& other) const {
+        BigFraction result;
+        Fraction64 fast;
+        if (!big && !other.big && small().checkedAdd(other.small(), fast) == FractionStatus::Ok) {
+            result.assign(fast);
+            return result;
+        }
+        BigInt d1 = getDenominator(), d2 = other.getDenominator();
+        result.assign(getNumerator() * d2 + other.getNumerator() * d1, d1 * d2);
+        return result;
+    }
+
+    BigFraction operator-(const BigFraction& other) const {
+        BigFraction result;
+        Fraction64 fast;
+        if (!big && !other.big && small().checkedSub(other.small(), fast) == FractionStatus::Ok) {
+            result.assign(fast);
+            return result;
+        }
+        BigInt d1 = getDenominator(), d2 = other.getDenominator();
+        result.assign(getNumerator() * d2 - other.getNumerator() * d1, d1 * d2);
+        return result;
+    }
+
+    BigFraction operator*(const BigFraction& other) const {
+        BigFraction result;
+        Fraction64 fast;
+        if (!big && !other.big && small().checkedMul(other.small(), fast) == FractionStatus::Ok) {
+            result.assign(fast);
+            return result;
+        }
+        result.assign(getNumerator() * other.getNumerator(), getDenominator() * other.getDenominator());
+        return result;
+    }
+
+    BigFraction operator/(const BigFraction& other) const {
+        BigFraction result;
+        if (!other.big && other.numerator == 0) {
+            std::cout << "Error: Division by zero.\n";
+            return result;                             //returns 0/1 to handle this case
+        }
+        Fraction64 fast;
+        if (!big && !other.big && small().checkedDiv(other.small(), fast) == FractionStatus::Ok) {
+            result.assign(fast);
+            return result;
+        }
+        result.assign(getNumerator() * other.getDenominator(), getDenominator() * other.getNumerator());
+        return result;
+    }
+
+/**
+* Public : operator==
+*
+* Description:
+*      Both sides are always reduced with a positive denominator, so equal
+*      values have identical parts. An inline value never equals a heap one.
+*/
+    bool operator==(const BigFraction& other) const {
+        if (!big && !other.big) {
+            return numerator == other.numerator && denominator == other.denominator;
+        }
+        if (!big || !other.big) {
+            return false;
+        }
+        return big->numerator == other.big->numerator && big->denominator == other.big->denominator;
+    }
+
+    bool operator!=(const BigFraction& other) const {
+        return !(*this == other);
+    }
+
+/**
+* Public : operator<< (Friend Function)
+*
+* Description:
+*      Prints the fraction as numerator/denominator with every digit.
+*/
+    friend std::ostream& operator<<(std::ostream& os, const BigFraction& frac) {
+        if (frac.big) {
+            os << frac.big->numerator << "/" << frac.big->denominator;
+        } else {
+            os << frac.numerator << "/" << frac.denominator;
+        }
+        return os;
+    }
+};
+
+#endif
@@ -0,0 +1,397 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            BigInt Class
+*  Title:            Arbitrary Precision Integer
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This class is a small signed bignum: a sign flag plus a vector of
+*        32 bit limbs, least significant first. It has just what BigFraction
+*        needs: add, subtract, multiply, exact long division (Knuth's
+*        algorithm D), GCD and conversion to and from int64 and text.
+*
+*  Usage:
+*       - BigInt a(INT64_MAX), b(3);
+*       - BigInt c = a * a + b;
+*       - cout << c;                      // prints every digit
+*
+*  Files:
+*       big_int.hpp : header file containing the BigInt class
+*****************************************************************************/
+
+#ifndef BIG_INT_HPP
+#define BIG_INT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * BigInt
+ *
+ * Description:
+ *      Signed arbitrary precision integer. Zero has no limbs and is never
+ *      negative, so every value has exactly one representation.
+ *
+ * Public Methods:
+ *      BigInt(int64_t value)
+ *      bool        isZero()
+ *      bool        isNegative()
+ *      bool        fitsInt64()
+ *      int64_t     toInt64()                 - Only valid when fitsInt64()
+ *      std::string toString()
+ *      BigInt      operator+ - * / %         - / truncates toward zero
+ *      bool        operator== != <
+ *      static BigInt gcd(BigInt a, BigInt b) - Always non-negative
+ *
+ * Private Methods:
+ *      static int  compareMagnitude(const Limbs& a, const Limbs& b)
+ *      static void addMagnitude / subMagnitude / mulMagnitude
+ *      static void divModMagnitude(const Limbs& u, const Limbs& v, Limbs& q, Limbs& r)
+ *
+ * Usage:
+ *      BigInt x(1);
+ *      for (int i = 0; i < 100; i++)
+ *          x = x * BigInt(2);           // 2^100
+ */
+class BigInt {
+    typedef std::vector<uint32_t> Limbs;
+
+    bool negative;              // Sign, never set for zero
+    Limbs limbs;                // Magnitude, least significant limb first
+
+    static void trim(Limbs& a) {
+        while (!a.empty() && a.back() == 0) {
+            a.pop_back();
+        }
+    }
+
+    void normalize() {
+        trim(limbs);
+        if (limbs.empty()) {
+            negative = false;
+        }
+    }
+
+    /**
+    * Private : compareMagnitude
+    *
+    * Returns:
+    *      int : -1, 0 or 1 as |a| is less than, equal to or greater than |b|
+    */
+    static int compareMagnitude(const Limbs& a, const Limbs& b) {
+        if (a.size() != b.size()) {
+            return a.size() < b.size() ? -1 : 1;
+        }
+        for (size_t i = a.size(); i-- > 0;) {
+            if (a[i] != b[i]) {
+                return a[i] < b[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    static Limbs addMagnitude(const Limbs& a, const Limbs& b) {
+        const Limbs& longer = a.size() >= b.size() ? a : b;
+        const Limbs& shorter = a.size() >= b.size() ? b : a;
+        Limbs out(longer.size() + 1);
+        uint64_t carry = 0;
+        for (size_t i = 0; i < longer.size(); ++i) {
+            uint64_t sum = (uint64_t)longer[i] + (i < shorter.size() ? shorter[i] : 0) + carry;
+            out[i] = (uint32_t)sum;
+            carry = sum >> 32;
+        }
+        out[longer.size()] = (uint32_t)carry;
+        trim(out);
+        return out;
+    }
+
+    // |a| - |b|, requires |a| >= |b|
+    static Limbs subMagnitude(const Limbs& a, const Limbs& b) {
+        Limbs out(a.size());
+        int64_t borrow = 0;
+        for (size_t i = 0; i < a.size(); ++i) {
+            int64_t diff = (int64_t)a[i] - (i < b.size() ? b[i] : 0) - borrow;
+            borrow = diff < 0 ? 1 : 0;
+            out[i] = (uint32_t)(diff + (borrow << 32));
+        }
+        trim(out);
+        return out;
+    }
+
+    static Limbs mulMagnitude(const Limbs& a, const Limbs& b) {
+        if (a.empty() || b.empty()) {
+            return Limbs();
+        }
+        Limbs out(a.size() + b.size(), 0);
+        for (size_t i = 0; i < a.size(); ++i) {
+            uint64_t carry = 0;
+            for (size_t j = 0; j < b.size(); ++j) {
+                uint64_t cur = (uint64_t)a[i] * b[j] + out[i + j] + carry;
+                out[i + j] = (uint32_t)cur;
+                carry = cur >> 32;
+            }
+            out[i + b.size()] = (uint32_t)carry;
+        }
+        trim(out);
+        return out;
+    }
+
+    /**
+    * Private : divModMagnitude
+    *
+    * Description:
+    *      q = |u| / |v| and r = |u| % |v| using Knuth's algorithm D (the
+    *      divmnu version from Hacker's Delight). v must not be zero.
+    */
+    static void divModMagnitude(const Limbs& u, const Limbs& v, Limbs& q, Limbs& r) {
+        if (compareMagnitude(u, v) < 0) {
+            q.clear();
+            r = u;
+            return;
+        }
+        const size_t n = v.size();
+        if (n == 1) {
+            q.assign(u.size(), 0);
+            uint64_t rem = 0;
+            for (size_t i = u.size(); i-- > 0;) {
+                uint64_t cur = (rem << 32) | u[i];
+                q[i] = (uint32_t)(cur / v[0]);
+                rem = cur % v[0];
+            }
+            trim(q);
+            r.clear();
+            if (rem != 0) {
+                r.push_back((uint32_t)rem);
+            }
+            return;
+        }
+
+        // Shift so the top limb of v has its high bit set
+        const int s = __builtin_clz(v[n - 1]);
+        const size_t m = u.size() - n;
+        Limbs vn(n), un(u.size() + 1);
+        for (size_t i = n - 1; i > 0; --i) {
+            vn[i] = (v[i] << s) | (s == 0 ? 0 : (uint32_t)((uint64_t)v[i - 1] >> (32 - s)));
+        }
+        vn[0] = v[0] << s;
+        un[u.size()] = s == 0 ? 0 : (uint32_t)((uint64_t)u[u.size() - 1] >> (32 - s));
+        for (size_t i = u.size() - 1; i > 0; --i) {
+            un[i] = (u[i] << s) | (s == 0 ? 0 : (uint32_t)((uint64_t)u[i - 1] >> (32 - s)));
+        }
+        un[0] = u[0] << s;
+
+        const uint64_t base = 1ULL << 32;
+        q.assign(m + 1, 0);
+        for (size_t j = m + 1; j-- > 0;) {
+            // Estimate the quotient digit from the top two limbs
+            uint64_t num = ((uint64_t)un[j + n] << 32) | un[j + n - 1];
+            uint64_t qhat = num / vn[n - 1];
+            uint64_t rhat = num % vn[n - 1];
+            while (qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+                --qhat;
+                rhat += vn[n - 1];
+                if (rhat >= base) {
+                    break;
+                }
+            }
+
+            // Multiply and subtract
+            int64_t k = 0;
+            int64_t t = 0;
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t p = qhat * vn[i];
+                t = (int64_t)un[i + j] - k - (int64_t)(p & 0xFFFFFFFFULL);
+                un[i + j] = (uint32_t)t;
+                k = (int64_t)(p >> 32) - (t >> 32);
+            }
+            t = (int64_t)un[j + n] - k;
+            un[j + n] = (uint32_t)t;
+
+            // Subtracted too much: add one v back
+            if (t < 0) {
+                --qhat;
+                uint64_t carry = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    uint64_t sum = (uint64_t)un[i + j] + vn[i] + carry;
+                    un[i + j] = (uint32_t)sum;
+                    carry = sum >> 32;
+                }
+                un[j + n] = (uint32_t)((uint64_t)un[j + n] + carry);
+            }
+            q[j] = (uint32_t)qhat;
+        }
+        trim(q);
+
+        // Undo the normalization shift on the remainder
+        r.assign(n, 0);
+        for (size_t i = 0; i < n; ++i) {
+            r[i] = (un[i] >> s) | (s == 0 ? 0 : (uint32_t)((uint64_t)un[i + 1] << (32 - s)));
+        }
+        trim(r);
+    }
+
+    static BigInt make(bool negative, Limbs limbs) {
+        BigInt out;
+        out.negative = negative;
+        out.limbs = std::move(limbs);
+        out.normalize();
+        return out;
+    }
+
+public:
+    /**
+    * Constructor
+    *
+    * Params:
+    *      int64_t value : Starting value (defaults to 0)
+    */
+    BigInt(int64_t value = 0) : negative(value < 0) {
+        uint64_t mag = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+        while (mag != 0) {
+            limbs.push_back((uint32_t)mag);
+            mag >>= 32;
+        }
+    }
+
+    bool isZero() const { return limbs.empty(); }
+    bool isNegative() const { return negative; }
+
+    /**
+    * Public : fitsInt64
+    *
+    * Returns:
+    *      bool : True if the value is in [INT64_MIN, INT64_MAX]
+    */
+    bool fitsInt64() const {
+        if (limbs.size() <= 1) {
+            return true;
+        }
+        if (limbs.size() > 2) {
+            return false;
+        }
+        uint64_t mag = ((uint64_t)limbs[1] << 32) | limbs[0];
+        return negative ? mag <= (1ULL << 63) : mag < (1ULL << 63);
+    }
+
+    int64_t toInt64() const {
+        uint64_t mag = 0;
+        for (size_t i = limbs.size(); i-- > 0;) {
+            mag = (mag << 32) | limbs[i];
+        }
+        return negative ? (int64_t)(0 - mag) : (int64_t)mag;
+    }
+
+    /**
+    * Public : toString
+    *
+    * Description:
+    *      Decimal text, peeling off nine digits at a time.
+    */
+    std::string toString() const {
+        if (limbs.empty()) {
+            return "0";
+        }
+        std::string out;
+        Limbs cur = limbs;
+        while (!cur.empty()) {
+            uint64_t rem = 0;
+            for (size_t i = cur.size(); i-- > 0;) {
+                uint64_t v = (rem << 32) | cur[i];
+                cur[i] = (uint32_t)(v / 1000000000);
+                rem = v % 1000000000;
+            }
+            trim(cur);
+            for (int d = 0; d < 9 && (!cur.empty() || rem != 0); ++d) {
+                out.push_back((char)('0' + rem % 10));
+                rem /= 10;
+            }
+        }
+        if (negative) {
+            out.push_back('-');
+        }
+        std::reverse(out.begin(), out.end());
+        return out;
+    }
+
+    BigInt operator-() const {
+        return make(!negative, limbs);
+    }
+
+    BigInt operator+(const BigInt& other) const {
+        if (negative == other.negative) {
+            return make(negative, addMagnitude(limbs, other.limbs));
+        }
+        int cmp = compareMagnitude(limbs, other.limbs);
+        if (cmp >= 0) {
+            return make(negative, subMagnitude(limbs, other.limbs));
+        }
+        return make(other.negative, subMagnitude(other.limbs, limbs));
+    }
+
+    BigInt operator-(const BigInt& other) const {
+        return *this + (-other);
+    }
+
+    BigInt operator*(const BigInt& other) const {
+        return make(negative != other.negative, mulMagnitude(limbs, other.limbs));
+    }
+
+    // Quotient truncated toward zero. other must not be zero.
+    BigInt operator/(const BigInt& other) const {
+        Limbs q, r;
+        divModMagnitude(limbs, other.limbs, q, r);
+        return make(negative != other.negative, std::move(q));
+    }
+
+    // Remainder with the sign of *this. other must not be zero.
+    BigInt operator%(const BigInt& other) const {
+        Limbs q, r;
+        divModMagnitude(limbs, other.limbs, q, r);
+        return make(negative, std::move(r));
+    }
+
+    bool operator==(const BigInt& other) const {
+        return negative == other.negative && limbs == other.limbs;
+    }
+
+    bool operator!=(const BigInt& other) const {
+        return !(*this == other);
+    }
+
+    bool operator<(const BigInt& other) const {
+        if (negative != other.negative) {
+            return negative;
+        }
+        int cmp = compareMagnitude(limbs, other.limbs);
+        return negative ? cmp > 0 : cmp < 0;
+    }
+
+    /**
+    * Public : gcd
+    *
+    * Description:
+    *      Euclid's algorithm on magnitudes. The result is never negative.
+    */
+    static BigInt gcd(BigInt a, BigInt b) {
+        a.negative = false;
+        b.negative = false;
+        while (!b.isZero()) {
+            BigInt r = a % b;
+            a = std::move(b);
+            b = std::move(r);
+        }
+        return a;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const BigInt& value) {
+        return os << value.toString();
+    }
+};
+
+#endif
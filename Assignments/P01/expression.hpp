@@ -0,0 +1,517 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            ExpressionEngine Class
+*  Title:            Fraction Expression Compiler
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This class evaluates whole fraction expressions such as
+*        "(1/2 + 3/4) * 5/6 - 7/8", with parentheses, unary minus and the
+*        usual precedence, plus one "==" comparison at the top level.
+*
+*        A line is first split into tokens. The literals are pulled out and
+*        the rest of the tokens form the expression's "shape" (for example
+*        "(n+n)*n-n"). Each new shape is compiled once into a short postfix
+*        bytecode, and every later line with the same shape reuses it with
+*        its own literals, so a file full of "a/b op c/d" lines is parsed by
+*        the compiler exactly once per operator.
+*
+*        An optional ResultCache keyed on the shape and the literal values
+*        lets repeated lines skip the math entirely.
+*
+*  Usage:
+*       - ExpressionEngine<int64_t> engine;
+*       - ExpressionResult<int64_t> result;
+*       - if (engine.evaluate(begin, end, line, result)) ... else engine.getError()
+*
+*  Files:
+*       expression.hpp      : header file containing the ExpressionEngine class
+*       fraction_parser.hpp : tokenizer used to read the literals
+*       fraction.hpp        : checked Fraction operations used by the VM
+*       result_cache.hpp    : bounded cache of expression results
+*****************************************************************************/
+
+#ifndef EXPRESSION_HPP
+#define EXPRESSION_HPP
+
+#include "fraction.hpp"
+#include "fraction_parser.hpp"
+#include "fraction_stats.hpp"
+#include "result_cache.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * OpCode
+ *
+ * Description:
+ *      One bytecode instruction. Push takes the next literal in textual
+ *      order, so no operand is needed.
+ */
+enum class OpCode : uint8_t { Push, Negate, Add, Sub, Mul, Div, Equal };
+
+/**
+ * CompiledExpression
+ *
+ * Description:
+ *      Bytecode for one expression shape.
+ */
+struct CompiledExpression {
+    std::vector<OpCode> code;       // Postfix program
+    size_t stackDepth;              // Largest stack the program needs
+    bool comparison;                // True if the program ends in Equal
+};
+
+/**
+ * ExpressionResult
+ *
+ * Description:
+ *      Outcome of evaluating one expression.
+ */
+template <typename T>
+struct ExpressionResult {
+    FractionStatus status;          // Overflow or DivideByZero if the math failed
+    bool comparison;                // True for "a == b" expressions
+    bool equal;                     // Result of the comparison
+    bool zeroDenominator;           // A literal had a 0 denominator (replaced by 1)
+    BasicFraction<T> value;         // Result of a non-comparison expression
+};
+
+/**
+ * ExpressionEngine
+ *
+ * Description:
+ *      Tokenizes, compiles (with a cache keyed by shape) and runs fraction
+ *      expressions. An engine keeps scratch buffers and its cache between
+ *      calls, so it is not thread safe: give each thread its own.
+ *
+ * Public Methods:
+ *      ExpressionEngine(size_t maxShapes)
+ *      bool evaluate(const char* begin, const char* end, size_t line, ExpressionResult<T>& result)
+ *      const ParseError& getError()
+ *      size_t getCompileCount()        - Shapes compiled so far
+ *      void enableResultCache(size_t maxBytes)
+ *      const CacheCounters* getCacheCounters()  - Null when the cache is off
+ *
+ * Private Methods:
+ *      bool tokenize(FractionParser& parser)
+ *      bool buildKey()                 - Fills key, returns true on a 0 denominator
+ *      bool compile(CompiledExpression& program)
+ *      bool parseSum / parseTerm / parseUnary / parsePrimary
+ *      void run(const CompiledExpression& program, ExpressionResult<T>& result)
+ *
+ * Usage:
+ *      ExpressionEngine<int64_t> engine;
+ *      ExpressionResult<int64_t> result;
+ *      string text = "(1/2 + 3/4) * 5/6";
+ *      if (engine.evaluate(text.data(), text.data() + text.size(), 1, result))
+ *          cout << result.value;         // 25/24
+ */
+template <typename T>
+class ExpressionEngine {
+    struct Token {
+        char kind;                  // 'n' literal, '~' unary minus, '=' for ==, else the character
+        const char* position;       // Where the token starts, for error columns
+    };
+
+    std::unordered_map<std::string, CompiledExpression> cache;  // Compiled programs by shape
+    size_t maxShapes;               // Cache is cleared when it grows past this
+    size_t compileCount;            // Number of shapes compiled
+
+    std::vector<Token> tokens;      // Tokens of the current line
+    std::vector<FractionToken<T> > literals;   // Literals of the current line, in order
+    std::vector<BasicFraction<T> > stack;      // VM stack
+    std::string shape;              // Token kinds of the current line, used as the cache key
+    const char* lineEnd;            // End of the current line, for errors at the end
+    FractionParser* parser;         // Parser of the current line, for error reporting
+    size_t next;                    // Next token while compiling
+    size_t depth;                   // Current stack depth while compiling
+    CompiledExpression* target;     // Program being compiled
+    ParseError error;               // Last error
+    std::unique_ptr<ResultCache<ExpressionResult<T> > > results;  // Optional result cache
+    std::string key;                // Cache key of the current line, reused between lines
+
+    /**
+    * Private : tokenize
+    *
+    * Description:
+    *      Splits the line into tokens, collecting literals and the shape key.
+    *      Whether a '-' is unary or binary depends on whether an operand is
+    *      expected, so that is decided here and baked into the shape.
+    *
+    * Returns:
+    *      bool : False with the error set if the line has a bad token
+    */
+    bool tokenize(FractionParser& in) {
+        FRACTION_STAGE(StatStage::Parse);
+        tokens.clear();
+        literals.clear();
+        shape.clear();
+        bool wantOperand = true;
+        while (true) {
+            char ch = in.peek();
+            const char* at = in.getPosition();
+            Token token = {ch, at};
+            if (wantOperand) {
+                if (ch == '(') {
+                    in.advance();
+                } else if ((ch >= '0' && ch <= '9') ||
+                           ((ch == '-' || ch == '+') && at + 1 < lineEnd && at[1] >= '0' && at[1] <= '9')) {
+                    FractionToken<T> literal;
+                    if (!in.parseFraction(literal)) {
+                        return false;
+                    }
+                    literals.push_back(literal);
+                    token.kind = 'n';
+                    wantOperand = false;
+                } else if (ch == '-') {
+                    in.advance();
+                    token.kind = '~';
+                } else if (ch == '+') {
+                    in.advance();
+                    continue;                           // unary plus does nothing
+                } else {
+                    return in.setError(at, "expected a fraction");
+                }
+            } else {
+                if (ch == '\0') {
+                    return true;
+                } else if (ch == ')') {
+                    in.advance();
+                } else if (ch == '+' || ch == '-' || ch == '*' || ch == '/') {
+                    in.advance();
+                    wantOperand = true;
+                } else if (ch == '=' && at + 1 < lineEnd && at[1] == '=') {
+                    in.advance(2);
+                    wantOperand = true;
+                } else if (std::ispunct((unsigned char)ch)) {
+                    return in.setError(at, "operator not recognized");
+                } else {
+                    return in.setError(at, "unexpected text after expression");
+                }
+            }
+            tokens.push_back(token);
+            shape.push_back(token.kind);
+        }
+    }
+
+    /**
+    * Private : buildKey
+    *
+    * Description:
+    *      Builds the result cache key: the shape followed by the raw bytes
+    *      of every literal, with a 0 denominator stored as 1 the same way
+    *      run() treats it. The shape fixes the number of literals, so no
+    *      separators are needed.
+    *
+    * Returns:
+    *      bool : True if any literal had a 0 denominator
+    */
+    bool buildKey() {
+        FRACTION_STAGE(StatStage::Parse);
+        key.assign(shape);
+        bool zeroDenominator = false;
+        for (const FractionToken<T>& literal : literals) {
+            T parts[2] = {literal.numerator, literal.denominator};
+            if (parts[1] == 0) {
+                zeroDenominator = true;
+                parts[1] = 1;
+            }
+            key.append(reinterpret_cast<const char*>(parts), sizeof(parts));
+        }
+        return zeroDenominator;
+    }
+
+    bool fail(const char* message) {
+        const char* at = next < tokens.size() ? tokens[next].position : lineEnd;
+        return parser->setError(at, message);
+    }
+
+    void emit(OpCode op) {
+        target->code.push_back(op);
+        if (op == OpCode::Push) {
+            ++depth;
+            if (depth > target->stackDepth) {
+                target->stackDepth = depth;
+            }
+        } else if (op != OpCode::Negate) {
+            --depth;
+        }
+    }
+
+    char peekKind() const {
+        return next < tokens.size() ? tokens[next].kind : '\0';
+    }
+
+    // primary := literal | '(' sum ')'
+    bool parsePrimary() {
+        char kind = peekKind();
+        if (kind == 'n') {
+            ++next;
+            emit(OpCode::Push);
+            return true;
+        }
+        if (kind == '(') {
+            ++next;
+            if (!parseSum()) {
+                return false;
+            }
+            if (peekKind() != ')') {
+                return fail("expected ')'");
+            }
+            ++next;
+            return true;
+        }
+        return fail("expected a fraction");
+    }
+
+    // unary := '-' unary | primary
+    bool parseUnary() {
+        if (peekKind() == '~') {
+            ++next;
+            if (!parseUnary()) {
+                return false;
+            }
+            emit(OpCode::Negate);
+            return true;
+        }
+        return parsePrimary();
+    }
+
+    // term := unary (('*' | '/') unary)*
+    bool parseTerm() {
+        if (!parseUnary()) {
+            return false;
+        }
+        while (peekKind() == '*' || peekKind() == '/') {
+            OpCode op = peekKind() == '*' ? OpCode::Mul : OpCode::Div;
+            ++next;
+            if (!parseUnary()) {
+                return false;
+            }
+            emit(op);
+        }
+        return true;
+    }
+
+    // sum := term (('+' | '-') term)*
+    bool parseSum() {
+        if (!parseTerm()) {
+            return false;
+        }
+        while (peekKind() == '+' || peekKind() == '-') {
+            OpCode op = peekKind() == '+' ? OpCode::Add : OpCode::Sub;
+            ++next;
+            if (!parseTerm()) {
+                return false;
+            }
+            emit(op);
+        }
+        return true;
+    }
+
+    /**
+    * Private : compile
+    *
+    * Description:
+    *      Compiles the current token list: expression := sum ['==' sum].
+    *
+    * Returns:
+    *      bool : False with the error set on a syntax error
+    */
+    bool compile(CompiledExpression& program) {
+        FRACTION_STAGE(StatStage::Compile);
+        program.code.clear();
+        program.stackDepth = 0;
+        program.comparison = false;
+        target = &program;
+        next = 0;
+        depth = 0;
+        if (!parseSum()) {
+            return false;
+        }
+        if (peekKind() == '=') {
+            ++next;
+            if (!parseSum()) {
+                return false;
+            }
+            emit(OpCode::Equal);
+            program.comparison = true;
+        }
+        if (next != tokens.size()) {
+            return fail(peekKind() == ')' ? "unmatched ')'" : "unexpected text after expression");
+        }
+        return true;
+    }
+
+    /**
+    * Private : run
+    *
+    * Description:
+    *      Executes a program on the current literals with the checked
+    *      Fraction operations, stopping at the first overflow or division by
+    *      zero. The value is always reduced, even when the line is a single
+    *      literal.
+    */
+    void run(const CompiledExpression& program, ExpressionResult<T>& result) {
+        FRACTION_STAGE(StatStage::Execute);
+        result.status = FractionStatus::Ok;
+        result.comparison = program.comparison;
+        result.equal = false;
+        result.zeroDenominator = false;
+        if (stack.size() < program.stackDepth) {
+            stack.resize(program.stackDepth);
+        }
+        size_t sp = 0;
+        size_t literal = 0;
+        for (OpCode op : program.code) {
+            if (op == OpCode::Push) {
+                const FractionToken<T>& lit = literals[literal++];
+                if (BasicFraction<T>::create(lit.numerator, lit.denominator, stack[sp++]) ==
+                    FractionStatus::ZeroDenominator) {
+                    result.zeroDenominator = true;
+                }
+                continue;
+            }
+            if (op == OpCode::Negate) {
+                BasicFraction<T> negated;
+                result.status = BasicFraction<T>(0, 1).checkedSub(stack[sp - 1], negated);
+                stack[sp - 1] = negated;
+            } else {
+                BasicFraction<T>& left = stack[sp - 2];
+                const BasicFraction<T>& right = stack[sp - 1];
+                BasicFraction<T> value;
+                switch (op) {
+                    case OpCode::Add:
+                        result.status = left.checkedAdd(right, value);
+                        break;
+                    case OpCode::Sub:
+                        result.status = left.checkedSub(right, value);
+                        break;
+                    case OpCode::Mul:
+                        result.status = left.checkedMul(right, value);
+                        break;
+                    case OpCode::Div:
+                        result.status = left.checkedDiv(right, value);
+                        break;
+                    default:
+                        result.equal = left == right;
+                        break;
+                }
+                left = value;
+                --sp;
+            }
+            if (result.status != FractionStatus::Ok) {
+                return;
+            }
+        }
+        if (program.code.size() == 1) {
+            // A lone literal went through no operator, so it has not been reduced yet
+            result.status = stack[0].checkedReduce(result.value);
+            return;
+        }
+        result.value = stack[0];
+    }
+
+public:
+    /**
+    * Constructor
+    *
+    * Params:
+    *      size_t maxShapes : Number of compiled shapes kept before the cache is reset
+    */
+    explicit ExpressionEngine(size_t maxShapes = 4096)
+        : maxShapes(maxShapes), compileCount(0), lineEnd(nullptr), parser(nullptr), next(0),
+          depth(0), target(nullptr), error{0, 0, ""} {}
+
+    /**
+    * Public : evaluate
+    *
+    * Description:
+    *      Tokenizes the line, finds or compiles the program for its shape
+    *      and runs it.
+    *
+    * Params:
+    *      const char* begin           : First character of the expression
+    *      const char* end             : One past the last character
+    *      size_t line                 : Line number used in errors
+    *      ExpressionResult<T>& result : Receives the result
+    *
+    * Returns:
+    *      bool : False on a syntax error (see getError()); math errors are
+    *             reported through result.status instead
+    */
+    bool evaluate(const char* begin, const char* end, size_t line, ExpressionResult<T>& result) {
+        FractionParser in(begin, end, line);
+        parser = &in;
+        lineEnd = end;
+        if (!tokenize(in)) {
+            error = in.getError();
+            return false;
+        }
+
+        typename std::unordered_map<std::string, CompiledExpression>::iterator found = cache.find(shape);
+        if (found == cache.end()) {
+            CompiledExpression program;
+            if (!compile(program)) {
+                error = in.getError();
+                return false;
+            }
+            if (cache.size() >= maxShapes) {
+                cache.clear();
+            }
+            ++compileCount;
+            found = cache.emplace(shape, std::move(program)).first;
+        }
+        if (!results) {
+            run(found->second, result);
+            return true;
+        }
+
+        bool zeroDenominator = buildKey();
+        const ExpressionResult<T>* hit = results->find(key);
+        if (hit != nullptr) {
+            result = *hit;
+            result.zeroDenominator = zeroDenominator;
+            return true;
+        }
+        run(found->second, result);
+        results->insert(key, result);
+        return true;
+    }
+
+    /**
+    * Public : enableResultCache
+    *
+    * Description:
+    *      Turns on result caching with an approximate memory limit. Repeated
+    *      lines (same shape and same literal values) are then answered from
+    *      the cache instead of being evaluated again.
+    *
+    * Params:
+    *      size_t maxBytes : Memory limit for this engine's cache
+    */
+    void enableResultCache(size_t maxBytes) {
+        results.reset(new ResultCache<ExpressionResult<T> >(maxBytes));
+    }
+
+    const CacheCounters* getCacheCounters() const {
+        return results ? &results->getCounters() : nullptr;
+    }
+
+    const ParseError& getError() const {
+        return error;
+    }
+
+    size_t getCompileCount() const {
+        return compileCount;
+    }
+};
+
+#endif
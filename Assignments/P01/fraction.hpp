@@ -0,0 +1,1052 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            Fraction Class
+*  Title:            Fraction Class Template
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This file defines the Fraction class as a template over its integer
+*        type, so the same code can run on 32, 64 or 128 bit integers. Every
+*        operator has a checked variant that reports overflow through a
+*        FractionStatus instead of returning a wrapped result, which lets a
+*        caller pick the narrowest type that is still safe for its data.
+*
+*        Everything except printing is constexpr, so constant fractions
+*        (and whole tables of them, via the _frac literal) are built and
+*        reduced by the compiler instead of at startup.
+*
+*  Usage:
+*       - Fraction   : int fractions (the original class)
+*       - Fraction64 : int64_t fractions
+*       - Fraction128: __int128 fractions (where the compiler has them)
+*       - f1.checkedAdd(f2, result) returns FractionStatus::Overflow instead
+*         of wrapping
+*       - constexpr Fraction64 half = "2/4"_frac;   // stored as 1/2
+*       - Fraction64::fromDouble(3.14159, 1000, pi) stores 355/113
+*
+*  Files:
+*       fraction.hpp : header file containing the BasicFraction template
+*       int_math.hpp : GCD and overflow checking kernels
+*****************************************************************************/
+
+#ifndef FRACTION_HPP
+#define FRACTION_HPP
+
+#include "int_math.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#ifdef __cpp_impl_three_way_comparison
+#include <compare>
+#endif
+
+/**
+ * FractionStatus
+ *
+ * Description:
+ *      Result of a checked Fraction operation.
+ */
+enum class FractionStatus { Ok, Overflow, DivideByZero, ZeroDenominator };
+
+/**
+ * ApproxWord
+ *
+ * Description:
+ *      Unsigned type fromDouble holds the exact value of a double in:
+ *      unsigned __int128 where the compiler has it, otherwise uint64_t.
+ */
+#ifdef __SIZEOF_INT128__
+typedef unsigned __int128 ApproxWord;
+#else
+typedef uint64_t ApproxWord;
+#endif
+
+/**
+ * statusMessage
+ *
+ * Description:
+ *      Human readable text for a FractionStatus.
+ */
+constexpr const char* statusMessage(FractionStatus status) {
+    switch (status) {
+        case FractionStatus::Ok:
+            return "Ok";
+        case FractionStatus::Overflow:
+            return "Overflow";
+        case FractionStatus::DivideByZero:
+            return "Division by zero";
+        case FractionStatus::ZeroDenominator:
+            return "Zero denominator replaced by 1";
+    }
+    return "Unknown";
+}
+
+/**
+ * writeInteger
+ *
+ * Description:
+ *      Writes any integer type to a stream. std::ostream has no overload for
+ *      __int128, so wide values are converted to digits by hand.
+ *
+ * Params:
+ *      std::ostream& os : The output stream
+ *      T value          : Value to print
+ *
+ * Returns:
+ *      std::ostream& : The updated output stream
+ */
+template <typename T>
+std::ostream& writeInteger(std::ostream& os, T value) {
+    if constexpr (sizeof(T) <= sizeof(long long)) {
+        os << value;
+    } else {
+        char digits[48];
+        char* p = digits + sizeof(digits);
+        typename UnsignedOf<T>::type mag = magnitude(value);
+        do {
+            *--p = (char)('0' + (int)(mag % 10));
+            mag /= 10;
+        } while (mag != 0);
+        if (value < 0) {
+            *--p = '-';
+        }
+        os.write(p, digits + sizeof(digits) - p);
+    }
+    return os;
+}
+
+/**
+ * BasicFraction
+ *
+ * Description:
+ *      This class represents a mathematical fraction and supports basic arithmetic operations
+ *      such as addition, subtraction, multiplication, and division. It also supports comparison
+ *      for equality. The class uses overloaded operators to perform these operations and provides
+ *      methods for accessing the numerator and denominator of the fraction. T is the integer
+ *      type used to store the numerator and denominator.
+ *
+ * Public Methods:
+ *                           BasicFraction(T num, T den)
+ *                           BasicFraction()
+ *      T                    getDenominator()
+ *      T                    getNumerator()
+ *      BasicFraction        reduced()
+ *      FractionStatus       checkedReduce(BasicFraction& result)          - reduced() that reports Overflow
+ *      FractionStatus       create(T num, T den, BasicFraction& result)   - Constructor that reports instead of printing
+ *      FractionStatus       fromDouble(double x, T maxDen, BasicFraction& result) - Closest fraction with den <= maxDen
+ *      FractionStatus       checkedAdd(const BasicFraction& other, BasicFraction& result)
+ *      FractionStatus       checkedSub(const BasicFraction& other, BasicFraction& result)
+ *      FractionStatus       checkedMul(const BasicFraction& other, BasicFraction& result)
+ *      FractionStatus       checkedDiv(const BasicFraction& other, BasicFraction& result)
+ *      BasicFraction        operator+(const BasicFraction& other)
+ *      BasicFraction        operator-(const BasicFraction& other)
+ *      BasicFraction        operator*(const BasicFraction& other)
+ *      BasicFraction        operator/(const BasicFraction& other)
+ *      int                  compare(const BasicFraction& other)         - -1, 0 or 1, never overflows
+ *      bool                 operator==(const BasicFraction& other)
+ *      bool                 operator!= / < / <= / > / >= (const BasicFraction& other)
+ *      std::weak_ordering   operator<=>(const BasicFraction& other)     - C++20 only
+ *      friend std::ostream& operator<<(std::ostream& os, const BasicFraction& frac)
+ *
+ * Private Methods:
+ *      T                    gcd(T a, T b)
+ *      FractionStatus       reduce(T num, T den, BasicFraction& result)
+ *      FractionStatus       wideSum(other, subtract, result) / wideProduct(other, result) - Exact fallbacks on overflow
+ *      FractionStatus       narrow<W>(W num, W den, BasicFraction& result) - Reduce in W, then fit into T
+ *      bool                 bestApproximation<V>(num, den, bound, p, q)    - Continued fraction walk for fromDouble
+ *
+ * Usage (Within Main):
+ *
+ *      Fraction f1(1, 2);                           // Create a Fraction object with numerator 1 and denominator 2
+ *      Fraction f2(3, 4);                           // Create another Fraction object with numerator 3 and denominator 4
+ *
+ *      Fraction sum = f1 + f2;                      // Add fractions
+ *      Fraction diff = f1 - f2;                     // Subtract fractions
+ *      Fraction prod = f1 * f2;                     // Multiply fractions
+ *      Fraction quot = f1 / f2;                     // Divide fractions
+ *      bool equal = (f1 == f2);                     // Compare fractions for equality
+ *
+ *      Fraction64 big;
+ *      if (Fraction64(1, 3).checkedAdd(Fraction64(1, 6), big) == FractionStatus::Ok)
+ *          cout << big;                             // 1/2
+ *
+ * Notes:
+ *      - If the denominator is initialized to 0, it will be adjusted to 1.
+ *      - Results of the operators are reduced and keep their sign in the numerator.
+ *      - The plain operators wrap on overflow like the built-in integer types. Use the
+ *        checked variants when the inputs might not fit.
+ */
+template <typename T>
+class BasicFraction {
+private:
+    T numerator;                                   //numerator is a private integer for storing the numerator of each fraction
+    T denominator;                                 //denominator is the same idea but for the denominator
+
+/**
+*Private : gcd
+*
+* Description:
+*      Computes the Greatest Common Divisor (GCD) of two integers. The result
+*      is never negative.
+*
+* Params:
+*      T a  : First integer
+*      T b  : Second integer
+*
+* Returns:
+*      T   : The GCD of the two integers.
+*/
+    static constexpr T gcd(T, T);
+
+/**
+* Private : reduce
+*
+* Description:
+*      Divides num and den by their GCD and moves the sign into the numerator.
+*
+* Params:
+*      T num                 : Numerator to reduce
+*      T den                 : Denominator to reduce (not zero)
+*      BasicFraction& result : Receives the reduced fraction
+*
+* Returns:
+*      FractionStatus : Overflow if the sign could not be moved, otherwise Ok
+*/
+    static constexpr FractionStatus reduce(T num, T den, BasicFraction& result);
+
+/**
+* Private : wideSum / wideProduct
+*
+* Description:
+*      The exact paths checkedAdd, checkedSub and checkedMul fall back to
+*      when a product overflows T. The result can still fit even though an
+*      unreduced intermediate did not, so the operands are reduced and the
+*      work is redone in WideOf<T>.
+*      wideSum uses Knuth's form: t = n1*(d2/g) +- n2*(d1/g) with
+*      g = gcd(d1, d2), then only gcd(t, g) can divide both t and the
+*      denominator (d1/g)*(d2/gcd(t, g)). For __int128, which has nothing
+*      wider, the same steps run in T with overflow checks.
+*
+* Returns:
+*      FractionStatus : Overflow only if the reduced result does not fit in T
+*/
+    constexpr FractionStatus wideSum(const BasicFraction& other, bool subtract, BasicFraction& result) const;
+    constexpr FractionStatus wideProduct(const BasicFraction& other, BasicFraction& result) const;
+
+/**
+* Private : narrow
+*
+* Description:
+*      Reduces num/den, computed in a type W at least as wide as T, moves
+*      the sign into the numerator and stores it if both parts fit in T.
+*/
+    template <typename W>
+    static constexpr FractionStatus narrow(W num, W den, BasicFraction& result);
+
+/**
+* Private : bestApproximation
+*
+* Description:
+*      Walks the continued fraction of num/den in the unsigned type V and
+*      stores the closest p/q with q <= bound. fromDouble calls it with
+*      64 bit V whenever the value fits, since 128 bit division is slow.
+*
+* Returns:
+*      bool : False if the numerator overflowed V
+*/
+    template <typename V>
+    static bool bestApproximation(ApproxWord num, ApproxWord den, ApproxWord bound, ApproxWord& p, ApproxWord& q);
+
+public:
+    typedef T value_type;                          //value_type is the integer type the fraction is stored in
+
+/**
+* Public : BasicFraction (Constructor)
+*
+* Description:
+*      Constructs a Fraction object with the given numerator and denominator.
+*      If the denominator is zero, it will be set to one, and a warning message will be displayed.
+*
+* Params:
+*      T num  : Numerator of the fraction
+*      T den  : Denominator of the fraction
+*/
+    constexpr BasicFraction(T num, T den) : numerator(num), denominator(den) {
+        if(den == 0)
+        {
+            std::cout << "You cannot divide by 0. The denominator will be set to 1.\n";
+            denominator = 1;
+        }
+    }
+
+/**
+* Public : BasicFraction (Default Constructor)
+*
+* Description:
+*      Constructs a Fraction object with default values of numerator and denominator set to 1.
+*/
+    constexpr BasicFraction() : numerator(1), denominator(1) {}
+
+/**
+* Public : getDenominator
+*
+* Description:
+*      Returns the denominator of the fraction.
+*
+* Returns:
+*      T   : The denominator of the fraction.
+*/
+    constexpr T getDenominator() const {
+        return denominator;
+    }
+
+/**
+* Public : getNumerator
+*
+* Description:
+*      Returns the numerator of the fraction.
+*
+* Returns:
+*      T   : The numerator of the fraction.
+*/
+    constexpr T getNumerator() const {
+        return numerator;
+    }
+
+/**
+* Public : reduced
+*
+* Description:
+*      Returns the fraction in lowest terms with its sign in the numerator.
+*      Usable in constant expressions, so constant tables can be stored
+*      already reduced.
+*
+* Returns:
+*      BasicFraction : The reduced fraction
+*/
+    constexpr BasicFraction reduced() const {
+        BasicFraction result;
+        reduce(numerator, denominator, result);
+        return result;
+    }
+
+/**
+* Public : checkedReduce
+*
+* Description:
+*      Like reduced(), but reports a sign that cannot be moved into the
+*      numerator (such as -2^63/-1 in 64 bits) instead of ignoring it.
+*
+* Params:
+*      BasicFraction& result : Receives the reduced fraction when Ok
+*
+* Returns:
+*      FractionStatus : Overflow if the sign could not be moved, otherwise Ok
+*/
+    constexpr FractionStatus checkedReduce(BasicFraction& result) const {
+        return reduce(numerator, denominator, result);
+    }
+
+/**
+* Public : create
+*
+* Description:
+*      Builds num/den like the constructor, but a zero denominator is
+*      reported through the return value instead of a message on cout, so
+*      it is safe to call from worker threads and from code that buffers its
+*      own output.
+*
+* Params:
+*      T num                 : Numerator of the fraction
+*      T den                 : Denominator of the fraction
+*      BasicFraction& result : Receives num/den, or num/1 if den is zero
+*
+* Returns:
+*      FractionStatus : ZeroDenominator if den was replaced, otherwise Ok
+*/
+    static constexpr FractionStatus create(T num, T den, BasicFraction& result) {
+        result.numerator = num;
+        result.denominator = den == 0 ? T(1) : den;
+        return den == 0 ? FractionStatus::ZeroDenominator : FractionStatus::Ok;
+    }
+
+/**
+* Public : fromDouble
+*
+* Description:
+*      Finds the fraction closest to x whose denominator is at most maxDen
+*      (ties go to the smaller denominator). The double is taken apart into
+*      its exact binary value and its continued fraction is walked one
+*      term at a time, so the work grows with log(maxDen), not maxDen. The
+*      answer is either the last convergent that fits or the best
+*      semiconvergent after it, which is always the best approximation.
+*      Values below 2^-73 lose the bits under 2^-126 first; that only
+*      matters for 128 bit fractions with denominators past 2^63. Without
+*      __int128 the value is held in 64 bits instead and bits under 2^-62
+*      are dropped, so values below about 2^-9 with a large maxDen can get
+*      a slightly worse answer.
+*
+* Params:
+*      double x              : Value to approximate
+*      T maxDen              : Largest denominator allowed (values below 1 mean 1)
+*      BasicFraction& result : Receives the reduced fraction, or 0/1 on failure
+*
+* Returns:
+*      FractionStatus : Overflow if x is NaN, infinite, or the answer does not fit in T
+*/
+    static FractionStatus fromDouble(double x, T maxDen, BasicFraction& result);
+
+/**
+* Public : checkedAdd / checkedSub / checkedMul / checkedDiv
+*
+* Description:
+*      Same as the matching operator, but every intermediate step is checked
+*      for overflow. The reduced result is stored in result when the status
+*      is Ok; otherwise result holds an unspecified value.
+*
+* Params:
+*      const BasicFraction& other : Right hand operand
+*      BasicFraction& result      : Receives the result
+*
+* Returns:
+*      FractionStatus : Ok, Overflow, or DivideByZero (checkedDiv only)
+*/
+    constexpr FractionStatus checkedAdd(const BasicFraction& other, BasicFraction& result) const;
+    constexpr FractionStatus checkedSub(const BasicFraction& other, BasicFraction& result) const;
+    constexpr FractionStatus checkedMul(const BasicFraction& other, BasicFraction& result) const;
+    constexpr FractionStatus checkedDiv(const BasicFraction& other, BasicFraction& result) const;
+
+/**
+* Public : operator+
+*
+* Description:
+*      Adds two Fraction objects and returns the result as a new Fraction object.
+*
+* Params:
+*      const BasicFraction& other : The fraction to be added to the current fraction.
+*
+* Returns:
+*      BasicFraction : The result of the addition.
+*/
+    constexpr BasicFraction operator+(const BasicFraction& other) const;
+
+/**
+* Public : operator-
+*
+* Description:
+*      Subtracts one Fraction object from another and returns the result as a new Fraction object.
+*
+* Params:
+*      const BasicFraction& other : The fraction to be subtracted from the current fraction.
+*
+* Returns:
+*      BasicFraction : The result of the subtraction.
+*/
+    constexpr BasicFraction operator-(const BasicFraction& other) const;
+
+/**
+* Public : operator*
+*
+* Description:
+*      Multiplies two Fraction objects and returns the result as a new Fraction object.
+*
+* Params:
+*      const BasicFraction& other : The fraction to be multiplied with the current fraction.
+*
+* Returns:
+*      BasicFraction : The result of the multiplication.
+*/
+    constexpr BasicFraction operator*(const BasicFraction& other) const;
+
+/**
+* Public : operator/
+*
+* Description:
+*      Divides one Fraction object by another and returns the result as a new Fraction object.
+*      Dividing by a zero fraction prints an error and returns 0/1.
+*
+* Params:
+*      const BasicFraction& other : The fraction to divide the current fraction by.
+*
+* Returns:
+*      BasicFraction : The result of the division.
+*/
+    constexpr BasicFraction operator/(const BasicFraction& other) const;
+
+/**
+* Public : compare
+*
+* Description:
+*      Orders two fractions by value. The cross products are formed in an
+*      integer twice as wide as T, so they always fit. For __int128, which
+*      has nothing wider, the cross products are used when they fit and
+*      compareRatios() is used when they do not. Either sign of
+*      denominator is handled.
+*
+* Params:
+*      const BasicFraction& other : The fraction to compare with
+*
+* Returns:
+*      int : -1, 0 or 1 as this fraction is less than, equal to or greater than other
+*/
+    constexpr int compare(const BasicFraction& other) const;
+
+/**
+* Public : operator==
+*
+* Description:
+*      Compares two Fraction objects for equality by value, so 2/4 == 1/2.
+*      Never overflows (see compare()).
+*
+* Params:
+*      const BasicFraction& other : The fraction to compare with the current fraction.
+*
+* Returns:
+*      bool   : True if the fractions are equal, false otherwise.
+*/
+    constexpr bool operator==(const BasicFraction& other) const;
+
+/**
+* Public : operator!= / operator< / operator<= / operator> / operator>=
+*
+* Description:
+*      Ordering by value, built on compare(). Fractions that are equal in
+*      value but written differently (2/4 and 1/2) are equivalent, so this
+*      is a weak ordering.
+*/
+    constexpr bool operator!=(const BasicFraction& other) const {
+        return compare(other) != 0;
+    }
+
+    constexpr bool operator<(const BasicFraction& other) const {
+        return compare(other) < 0;
+    }
+
+    constexpr bool operator<=(const BasicFraction& other) const {
+        return compare(other) <= 0;
+    }
+
+    constexpr bool operator>(const BasicFraction& other) const {
+        return compare(other) > 0;
+    }
+
+    constexpr bool operator>=(const BasicFraction& other) const {
+        return compare(other) >= 0;
+    }
+
+#ifdef __cpp_impl_three_way_comparison
+    constexpr std::weak_ordering operator<=>(const BasicFraction& other) const {
+        int order = compare(other);
+        return order < 0 ? std::weak_ordering::less
+                         : (order > 0 ? std::weak_ordering::greater : std::weak_ordering::equivalent);
+    }
+#endif
+
+/**
+* Public : operator<< (Friend Function)
+*
+* Description:
+*      Overloads the output stream operator to allow printing of Fraction objects.
+*
+* Params:
+*      std::ostream& os : The output stream.
+*      const BasicFraction& frac : The fraction to be printed.
+*
+* Returns:
+*      std::ostream& : The updated output stream.
+*/
+    friend std::ostream& operator<<(std::ostream& os, const BasicFraction& frac) {
+        writeInteger(os, frac.numerator);
+        os << "/";
+        writeInteger(os, frac.denominator);
+        return os;
+    }
+};
+
+typedef BasicFraction<int> Fraction;               //Fraction is the original int based class
+typedef BasicFraction<int32_t> Fraction32;
+typedef BasicFraction<int64_t> Fraction64;
+#ifdef __SIZEOF_INT128__
+typedef BasicFraction<__int128> Fraction128;
+#endif
+
+/**
+ * std::hash<BasicFraction<T>>
+ *
+ * Description:
+ *      Hashes the reduced form, so fractions that compare equal (2/4 and
+ *      1/2, or 1/-2 and -1/2) hash the same and can share a hash table.
+ *      The form is built from the magnitudes in the unsigned type with the
+ *      sign kept apart, so it exists even where reduced() cannot move the
+ *      sign (a denominator of INT64_MIN): 0/-9223372036854775808 hashes as
+ *      0/1 and -9223372036854775808/-9223372036854775808 as 1/1.
+ */
+namespace std {
+template <typename T>
+struct hash<BasicFraction<T> > {
+    size_t operator()(const BasicFraction<T>& frac) const {
+        typedef typename UnsignedOf<T>::type U;
+        U num = magnitude(frac.getNumerator());
+        U den = magnitude(frac.getDenominator());
+        bool negative = num != 0 && (frac.getNumerator() < 0) != (frac.getDenominator() < 0);
+        U divisor = fastGcd(num, den);                                                      //gcd(0, den) is den, so zero always hashes as 0/1
+        if (divisor > 1) {
+            num /= divisor;
+            den /= divisor;
+        }
+        U parts[2] = {negative ? U(0) - num : num, den};
+        uint64_t h = 0x9e3779b97f4a7c15ULL;
+        for (U part : parts) {
+            for (size_t shift = 0; shift < sizeof(U) * 8; shift += 64) {
+                h ^= (uint64_t)(part >> shift) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            }
+        }
+        return (size_t)h;
+    }
+};
+}
+
+/**
+ * operator"" _frac
+ *
+ * Description:
+ *      Fraction64 literals. "3/4"_frac parses the text at compile time and
+ *      stores the reduced fraction, and 5_frac is 5/1. A malformed literal,
+ *      a value past INT64_MAX or a zero denominator used in a constant
+ *      expression is a compile error.
+ *
+ * Usage:
+ *      constexpr Fraction64 weights[] = {"1/2"_frac, "-2/6"_frac, 3_frac};
+ */
+constexpr Fraction64 operator""_frac(unsigned long long value) {
+    if (value > (unsigned long long)INT64_MAX) {
+        throw "fraction literal out of range";
+    }
+    return Fraction64((int64_t)value, 1);
+}
+
+constexpr Fraction64 operator""_frac(const char* text, size_t length) {
+    int64_t parts[2] = {0, 1};                                                              //parts holds the numerator and denominator as they are read
+    int part = 0;
+    bool negative = false;
+    bool digits = false;
+    for (size_t i = 0; i < length; i++) {
+        char ch = text[i];
+        if (ch == ' ') {
+            continue;
+        } else if (ch == '-' && !digits && !negative && part == 0) {
+            negative = true;
+        } else if (ch == '/' && digits && part == 0) {
+            part = 1;
+            parts[1] = 0;
+            digits = false;
+        } else if (ch >= '0' && ch <= '9') {
+            if (mulOverflow(parts[part], int64_t(10), parts[part]) ||
+                addOverflow(parts[part], int64_t(ch - '0'), parts[part])) {
+                throw "fraction literal out of range";
+            }
+            digits = true;
+        } else {
+            throw "malformed fraction literal";
+        }
+    }
+    if (!digits || parts[1] == 0) {
+        throw "malformed fraction literal";
+    }
+    return Fraction64(negative ? -parts[0] : parts[0], parts[1]).reduced();
+}
+
+    // Checked addition
+    template <typename T>
+    constexpr FractionStatus BasicFraction<T>::checkedAdd(const BasicFraction& other, BasicFraction& result) const {
+    FRACTION_COUNT(StatOp::Add);
+    FRACTION_OPERAND(magnitude(numerator) | magnitude(denominator));
+    FRACTION_OPERAND(magnitude(other.numerator) | magnitude(other.denominator));
+    T g = gcd(denominator, other.denominator);                                              //g is the common factor of both denominators, dividing it out first keeps every product small
+    T scale1 = other.denominator / g;                                                       //scale1 and scale2 are what each numerator is multiplied by to reach the common denominator
+    T scale2 = denominator / g;
+
+    T adjustedNumerator1 = 0, adjustedNumerator2 = 0, resultNumerator = 0, resultDenominator = 0;
+    bool overflow = mulOverflow(numerator, scale1, adjustedNumerator1);
+    overflow |= mulOverflow(other.numerator, scale2, adjustedNumerator2);
+    overflow |= addOverflow(adjustedNumerator1, adjustedNumerator2, resultNumerator);
+    overflow |= mulOverflow(denominator, scale1, resultDenominator);                         //resultDenominator is the lcm of both denominators, d1 * (d2 / g)
+
+    if (overflow || resultDenominator == 0) {
+        return wideSum(other, false, result);                                               //an intermediate overflowed, the reduced sum may still fit
+    }
+    return reduce(resultNumerator, resultDenominator, result);
+    }
+
+    // Checked subtraction
+    template <typename T>
+    constexpr FractionStatus BasicFraction<T>::checkedSub(const BasicFraction& other, BasicFraction& result) const {
+    FRACTION_COUNT(StatOp::Sub);
+    FRACTION_OPERAND(magnitude(numerator) | magnitude(denominator));
+    FRACTION_OPERAND(magnitude(other.numerator) | magnitude(other.denominator));
+    T g = gcd(denominator, other.denominator);
+    T scale1 = other.denominator / g;
+    T scale2 = denominator / g;
+
+    T adjustedNumerator1 = 0, adjustedNumerator2 = 0, resultNumerator = 0, resultDenominator = 0;
+    bool overflow = mulOverflow(numerator, scale1, adjustedNumerator1);
+    overflow |= mulOverflow(other.numerator, scale2, adjustedNumerator2);
+    overflow |= subOverflow(adjustedNumerator1, adjustedNumerator2, resultNumerator);
+    overflow |= mulOverflow(denominator, scale1, resultDenominator);
+
+    if (overflow || resultDenominator == 0) {
+        return wideSum(other, true, result);
+    }
+    return reduce(resultNumerator, resultDenominator, result);
+    }
+
+    // Checked multiplication
+    template <typename T>
+    constexpr FractionStatus BasicFraction<T>::checkedMul(const BasicFraction& other, BasicFraction& result) const {
+    FRACTION_COUNT(StatOp::Mul);
+    FRACTION_OPERAND(magnitude(numerator) | magnitude(denominator));
+    FRACTION_OPERAND(magnitude(other.numerator) | magnitude(other.denominator));
+    T g1 = gcd(numerator, other.denominator);                                               //g1 and g2 are cancelled across the two fractions before multiplying so the products stay small
+    T g2 = gcd(other.numerator, denominator);
+
+    T resultNumerator = 0, resultDenominator = 0;
+    bool overflow = mulOverflow(numerator / g1, other.numerator / g2, resultNumerator);
+    overflow |= mulOverflow(denominator / g2, other.denominator / g1, resultDenominator);
+
+    if (overflow || resultDenominator == 0) {
+        return wideProduct(other, result);                                                  //unreduced operands can overflow a product whose reduced form fits
+    }
+    return reduce(resultNumerator, resultDenominator, result);
+    }
+
+    // Exact sum or difference in the wide type, by Knuth's method
+    template <typename T>
+    constexpr FractionStatus BasicFraction<T>::wideSum(const BasicFraction& other, bool subtract, BasicFraction& result) const {
+    typedef typename WideOf<T>::type W;
+    BasicFraction left = *this, right = other;                                              //Knuth's method needs reduced operands
+    if (reduce(numerator, denominator, left) != FractionStatus::Ok || reduce(other.numerator, other.denominator, right) != FractionStatus::Ok) {
+        left = *this;
+        right = other;
+    }
+    result = BasicFraction(0, 1);
+    W g = fastGcd((W)left.denominator, (W)right.denominator);
+    if (g == 0) {
+        return FractionStatus::Overflow;
+    }
+    W scale1 = (W)right.denominator / g;
+    W scale2 = (W)left.denominator / g;
+    W product1 = 0, product2 = 0, t = 0, den = 0;
+    bool overflow = mulOverflow((W)left.numerator, scale1, product1);
+    overflow |= mulOverflow((W)right.numerator, scale2, product2);
+    overflow |= subtract ? subOverflow(product1, product2, t) : addOverflow(product1, product2, t);
+    if (overflow) {
+        return FractionStatus::Overflow;
+    }
+    W g2 = fastGcd(t, g);                                                                   //g2 is the only part of g that t still shares
+    if (g2 > 1) {
+        t /= g2;
+    } else {
+        g2 = 1;
+    }
+    if (mulOverflow(scale2, W((W)right.denominator / g2), den)) {
+        return FractionStatus::Overflow;
+    }
+    return narrow(t, den, result);
+    }
+
+    // Exact product in the wide type
+    template <typename T>
+    constexpr FractionStatus BasicFraction<T>::wideProduct(const BasicFraction& other, BasicFraction& result) const {
+    typedef typename WideOf<T>::type W;
+    BasicFraction left = *this, right = other;                                              //with reduced operands the cross cancelled product is already reduced
+    if (reduce(numerator, denominator, left) != FractionStatus::Ok || reduce(other.numerator, other.denominator, right) != FractionStatus::Ok) {
+        left = *this;
+        right = other;
+    }
+    result = BasicFraction(0, 1);
+    W g1 = fastGcd((W)left.numerator, (W)right.denominator);
+    W g2 = fastGcd((W)right.numerator, (W)left.denominator);
+    g1 = g1 > 0 ? g1 : 1;
+    g2 = g2 > 0 ? g2 : 1;
+    W num = 0, den = 0;
+    if (mulOverflow(W((W)left.numerator / g1), W((W)right.numerator / g2), num) ||
+        mulOverflow(W((W)left.denominator / g2), W((W)right.denominator / g1), den)) {
+        return FractionStatus::Overflow;
+    }
+    return narrow(num, den, result);
+    }
+
+    // Reduce in W and fit the result into T
+    template <typename T>
+    template <typename W>
+    constexpr FractionStatus BasicFraction<T>::narrow(W num, W den, BasicFraction& result) {
+    if (den == 0) {
+        return FractionStatus::Overflow;
+    }
+    W divisor = fastGcd(num, den);                                                          //operands are not always reduced, so the whole gcd is taken
+    if (divisor > 1) {
+        num /= divisor;
+        den /= divisor;
+    }
+    if (den < 0 && (subOverflow(W(0), num, num) || subOverflow(W(0), den, den))) {
+        return FractionStatus::Overflow;
+    }
+    if ((W)(T)num != num || (W)(T)den != den) {
+        return FractionStatus::Overflow;
+    }
+    result.numerator = (T)num;
+    result.denominator = (T)den;
+    return FractionStatus::Ok;
+    }
+
+    // Checked division
+    template <typename T>
+    constexpr FractionStatus BasicFraction<T>::checkedDiv(const BasicFraction& other, BasicFraction& result) const {
+    FRACTION_COUNT(StatOp::Div);
+    FRACTION_OPERAND(magnitude(numerator) | magnitude(denominator));
+    FRACTION_OPERAND(magnitude(other.numerator) | magnitude(other.denominator));
+    if (other.numerator == 0) {
+        result = BasicFraction(0, 1);
+        return FractionStatus::DivideByZero;
+    }
+    BasicFraction reciprocal;                                                               //reciprocal is other flipped over, so dividing becomes multiplying
+    reciprocal.numerator = other.denominator;
+    reciprocal.denominator = other.numerator;
+    return checkedMul(reciprocal, result);
+    }
+
+    // Overloaded addition operator
+    template <typename T>
+    constexpr BasicFraction<T> BasicFraction<T>::operator+(const BasicFraction& other) const {
+    BasicFraction result;
+    checkedAdd(other, result);
+    return result;
+    }
+
+    // Overloaded subtraction operator
+    template <typename T>
+    constexpr BasicFraction<T> BasicFraction<T>::operator-(const BasicFraction& other) const {
+    BasicFraction result;
+    checkedSub(other, result);
+    return result;
+    }
+
+    // Overloaded multiplication operator
+    template <typename T>
+    constexpr BasicFraction<T> BasicFraction<T>::operator*(const BasicFraction& other) const {
+    BasicFraction result;
+    checkedMul(other, result);
+    return result;
+    }
+
+    // Overloaded division operator
+    template <typename T>
+    constexpr BasicFraction<T> BasicFraction<T>::operator/(const BasicFraction& other) const {
+    BasicFraction result;
+    if (checkedDiv(other, result) == FractionStatus::DivideByZero) {
+        std::cout << "Error: Division by zero.\n";
+        return BasicFraction(0, 1);                                                         //returns a default fraction to handle this case
+    }
+    return result;
+    }
+
+    // Overloaded equality operator (==)
+    template <typename T>
+    constexpr bool BasicFraction<T>::operator==(const BasicFraction& other) const {
+    return compare(other) == 0;
+    }
+
+    // Three way comparison by value
+    template <typename T>
+    constexpr int BasicFraction<T>::compare(const BasicFraction& other) const {
+    FRACTION_COUNT(StatOp::Compare);
+    FRACTION_OPERAND(magnitude(numerator) | magnitude(denominator));
+    FRACTION_OPERAND(magnitude(other.numerator) | magnitude(other.denominator));
+    typedef typename WideOf<T>::type W;
+    if constexpr (sizeof(W) > sizeof(T)) {
+        W crossProduct1 = (W)numerator * (W)other.denominator;                              //n1/d1 < n2/d2 exactly when n1*d2 < n2*d1, if d1*d2 > 0
+        W crossProduct2 = (W)other.numerator * (W)denominator;
+        int order = (crossProduct1 > crossProduct2) - (crossProduct1 < crossProduct2);
+        return (denominator < 0) != (other.denominator < 0) ? -order : order;
+    } else {
+        T crossProduct1 = 0, crossProduct2 = 0;
+        if (!mulOverflow(numerator, other.denominator, crossProduct1) &&
+            !mulOverflow(other.numerator, denominator, crossProduct2)) {
+            int order = (crossProduct1 > crossProduct2) - (crossProduct1 < crossProduct2);
+            return (denominator < 0) != (other.denominator < 0) ? -order : order;
+        }
+        int sign1 = numerator == 0 ? 0 : ((numerator < 0) != (denominator < 0) ? -1 : 1);     //sign1 and sign2 are the signs of the two values
+        int sign2 = other.numerator == 0 ? 0 : ((other.numerator < 0) != (other.denominator < 0) ? -1 : 1);
+        if (sign1 != sign2 || sign1 == 0) {
+            return (sign1 > sign2) - (sign1 < sign2);
+        }
+        int order = compareRatios(magnitude(numerator), magnitude(denominator),
+                                  magnitude(other.numerator), magnitude(other.denominator));
+        return sign1 < 0 ? -order : order;
+    }
+    }
+
+    // Continued fraction walk shared by fromDouble
+    template <typename T>
+    template <typename V>
+    bool BasicFraction<T>::bestApproximation(ApproxWord numWide, ApproxWord denWide, ApproxWord boundWide,
+                                             ApproxWord& p, ApproxWord& q) {
+    V num = (V)numWide, den = (V)denWide;
+    V bound = boundWide > (V)-1 ? (V)-1 : (V)boundWide;
+    V p0 = 0, q0 = 1, p1 = 1, q1 = 0;                                                       //p1/q1 is the latest convergent and p0/q0 the one before it
+    while (true) {
+        V term = num / den;
+        V p2 = 0, q2 = 0;
+        if (mulOverflow(term, q1, q2) || addOverflow(q2, q0, q2) || q2 > bound) {
+            break;
+        }
+        if (mulOverflow(term, p1, p2) || addOverflow(p2, p0, p2)) {
+            return false;
+        }
+        p0 = p1;
+        q0 = q1;
+        p1 = p2;
+        q1 = q2;
+        V rest = num - term * den;
+        num = den;
+        den = rest;
+        if (den == 0) {
+            break;
+        }
+    }
+
+    p = p1;
+    q = q1;
+    if (den != 0) {
+        // The semiconvergent (p0 + k*p1)/(q0 + k*q1) with the largest k that fits is
+        // closer than p1/q1 exactly when the remaining quotient num/den is below 2k + q0/q1
+        V k = (bound - q0) / q1;
+        V semiP = 0;
+        V semiQ = q0 + k * q1;
+        V limit = 0;                                                                        //limit is 2k*q1 + q0, which can pass the top of V
+        int order = 0;
+        if (!addOverflow(semiQ, V(k * q1), limit)) {
+            order = compareRatios(num, den, limit, q1);
+        } else {
+            // Compare whole parts first: num/den against 2k + q0/q1, taking k off twice so nothing overflows
+            V whole = num / den;
+            V left = whole < k ? 0 : whole - k;
+            V right = k + q0 / q1;
+            if (whole < k || left < right) {
+                order = -1;
+            } else if (left > right) {
+                order = 1;
+            } else {
+                order = compareRatios(V(num % den), den, V(q0 % q1), q1);
+            }
+        }
+        if (order < 0) {
+            if (mulOverflow(k, p1, semiP) || addOverflow(semiP, p0, semiP)) {
+                return false;
+            }
+            p = semiP;
+            q = semiQ;
+        }
+    }
+    return true;
+    }
+
+    // Best rational approximation by continued fractions
+    template <typename T>
+    FractionStatus BasicFraction<T>::fromDouble(double x, T maxDen, BasicFraction& result) {
+    typedef ApproxWord U;
+    const int bits = (int)sizeof(U) * 8;
+    result = BasicFraction(0, 1);
+    if (!std::isfinite(x)) {
+        return FractionStatus::Overflow;
+    }
+    int exponent = 0;
+    U num = (U)std::ldexp(std::frexp(std::fabs(x), &exponent), 53);                        //num * 2^exponent is exactly |x|, with num a 53 bit integer
+    exponent -= 53;
+    U den = 1;
+    if (num == 0) {
+        return FractionStatus::Ok;
+    }
+    if (exponent > 0) {
+        if (exponent > bits - 1 - 53) {
+            return FractionStatus::Overflow;
+        }
+        num <<= exponent;
+    } else {
+        int shift = -exponent;
+        int zeros = countTrailingZeros(num);                                                //dropping common factors of 2 keeps den as small as possible
+        zeros = zeros < shift ? zeros : shift;
+        num >>= zeros;
+        shift -= zeros;
+        if (shift > bits - 2) {                                                             //below 2^-73, so only the bits above 2^-126 can change the answer
+            int drop = shift - (bits - 2);
+            num = drop > 60 ? 0 : (num + ((U)1 << (drop - 1))) >> drop;                     //num has 53 bits, so any drop past 54 rounds to 0
+            shift = bits - 2;
+            if (num == 0) {
+                return FractionStatus::Ok;
+            }
+        }
+        den = (U)1 << shift;
+    }
+
+    U bound = maxDen < 1 ? 1 : (U)maxDen;
+    U p = 0, q = 1;
+    bool fits = num <= (U)UINT64_MAX && den <= (U)UINT64_MAX;                               //most doubles fit in 64 bits, where each division is several times cheaper
+    if (fits ? !bestApproximation<uint64_t>(num, den, bound, p, q) : !bestApproximation<U>(num, den, bound, p, q)) {
+        return FractionStatus::Overflow;
+    }
+    if (p > (U)std::numeric_limits<T>::max()) {
+        return FractionStatus::Overflow;
+    }
+    result = BasicFraction(x < 0 ? -(T)p : (T)p, (T)q);
+    return FractionStatus::Ok;
+    }
+
+    // Function to reduce a fraction and move its sign into the numerator
+    template <typename T>
+    constexpr FractionStatus BasicFraction<T>::reduce(T num, T den, BasicFraction& result) {
+    T divisor = gcd(num, den);                                                              //divisor is the gcd and is used to simplify the result
+    if (divisor > 1) {
+        num /= divisor;
+        den /= divisor;
+    }
+    if (den < 0) {
+        bool overflow = subOverflow(T(0), num, num);
+        overflow |= subOverflow(T(0), den, den);
+        if (overflow) {
+            result.numerator = num;
+            result.denominator = den;
+            return FractionStatus::Overflow;
+        }
+    }
+    result.numerator = num;
+    result.denominator = den;
+    return FractionStatus::Ok;
+    }
+
+    // Function to calculate Greatest Common Divisor (GCD)
+    // The kernel lives in int_math.hpp: binary GCD by default, Euclid with -DFRACTION_GCD_EUCLID
+    template <typename T>
+    constexpr T BasicFraction<T>::gcd(T a, T b) {
+    return fastGcd(a, b);
+    }
+
+// Cases that once went wrong, checked by the compiler so a regression stops the build.
+// 799451325/3694501010 - -1408718361/4152556563 fits in 64 bits, but d1 * (d2 / g) does not.
+static_assert([] {
+    Fraction64 difference(0, 1);
+    return Fraction64(799451325, 3694501010).checkedSub(Fraction64(-1408718361, 4152556563), difference) == FractionStatus::Ok &&
+           difference.getNumerator() == 568285216929856039 && difference.getDenominator() == 1022774961072375242;
+}(), "checkedSub must not overflow when the reduced result fits");
+static_assert([] {
+    Fraction64 sum(0, 1);
+    return Fraction64(799451325, 3694501010).checkedAdd(Fraction64(1408718361, 4152556563), sum) == FractionStatus::Ok &&
+           sum.getNumerator() == 568285216929856039 && sum.getDenominator() == 1022774961072375242;
+}(), "checkedAdd must not overflow when the reduced result fits");
+
+#endif
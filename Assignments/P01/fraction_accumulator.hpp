@@ -0,0 +1,321 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            FractionAccumulator Class
+*  Title:            Lazily Reduced Running Sum and Product
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        Every Fraction operator reduces its result with a GCD, so a sum of N
+*        fractions pays for N reductions. This class keeps a running
+*        numerator and denominator in an integer twice as wide as T and does
+*        not reduce after each step. Adding or multiplying is then just a
+*        few checked multiply-adds. Only when one of them would overflow is
+*        the running value reduced (and the step retried with the LCM of the
+*        denominators), and the final reduction happens when the result is
+*        read.
+*
+*  Usage:
+*       - FractionAccumulator<int64_t> sum;       // 0/1
+*       - sum += Fraction64(1, 3);
+*       - Fraction64 total;
+*       - if (sum.result(total) == FractionStatus::Ok) cout << total;
+*
+*  Files:
+*       fraction_accumulator.hpp : header file containing the FractionAccumulator class
+*       fraction.hpp             : BasicFraction and FractionStatus
+*       int_math.hpp             : WideOf, GCD and overflow checked helpers
+*****************************************************************************/
+
+#ifndef FRACTION_ACCUMULATOR_HPP
+#define FRACTION_ACCUMULATOR_HPP
+
+#include "fraction.hpp"
+#include "int_math.hpp"
+#include <cstddef>
+
+/**
+ * FractionAccumulator
+ *
+ * Description:
+ *      Running sum or product of BasicFraction<T> values held unreduced in
+ *      WideOf<T>::type (int64_t for int32_t, __int128 for int64_t). The
+ *      denominator is always positive. Errors are sticky: after an overflow
+ *      or a division by zero every later step is ignored and result()
+ *      reports the first error.
+ *
+ * Public Methods:
+ *                           FractionAccumulator()
+ *                           FractionAccumulator(const BasicFraction<T>& start)
+ *      void                 add(const BasicFraction<T>& f)   - Also operator+=
+ *      void                 sub(const BasicFraction<T>& f)   - Also operator-=
+ *      void                 mul(const BasicFraction<T>& f)   - Also operator*=
+ *      void                 div(const BasicFraction<T>& f)   - Also operator/=
+ *      FractionStatus       result(BasicFraction<T>& out)    - Reduce and read the value
+ *      FractionStatus       getStatus()
+ *      size_t               getReductionCount()              - GCD reductions done so far
+ *
+ * Private Methods:
+ *      void                 normalize()                      - Reduce the running value
+ *      bool                 load(const BasicFraction<T>& f, W& n, W& d)
+ *      bool                 addParts(W n, W d)
+ *      bool                 mulParts(W n, W d)
+ *
+ * Usage:
+ *      FractionAccumulator<int64_t> harmonic;
+ *      for (int64_t i = 1; i <= 20; i++)
+ *          harmonic += Fraction64(1, i);
+ *      Fraction64 h;
+ *      harmonic.result(h);                      // 55835135/15519504
+ *
+ * Notes:
+ *      - The result must still fit in T; result() returns Overflow if it
+ *        does not, even when the wide running value was fine.
+ *      - For __int128 there is no wider type, so the running value only
+ *        has the headroom of the reductions it skips.
+ */
+template <typename T>
+class FractionAccumulator {
+    typedef typename WideOf<T>::type W;
+
+    W numerator;                    // Running numerator, not reduced
+    W denominator;                  // Running denominator, always positive
+    FractionStatus status;          // First error, or Ok
+    size_t reductions;              // Number of times normalize() ran
+
+    /**
+    * Private : normalize
+    *
+    * Description:
+    *      Divides the running numerator and denominator by their GCD.
+    */
+    void normalize() {
+        W g = fastGcd(numerator, denominator);
+        if (g > 1) {
+            numerator /= g;
+            denominator /= g;
+        }
+        ++reductions;
+    }
+
+    /**
+    * Private : load
+    *
+    * Description:
+    *      Widens f into n and d and moves its sign into the numerator.
+    *
+    * Returns:
+    *      bool : False if the sign could not be moved (only for __int128)
+    */
+    static bool load(const BasicFraction<T>& f, W& n, W& d) {
+        n = f.getNumerator();
+        d = f.getDenominator();
+        if (d < 0) {
+            return !subOverflow(W(0), n, n) && !subOverflow(W(0), d, d);
+        }
+        return true;
+    }
+
+    /**
+    * Private : addParts
+    *
+    * Description:
+    *      Adds n/d (d > 0). The fast path cross-multiplies without any GCD,
+    *      or just adds numerators when the denominators match. If that
+    *      overflows, the running value and n/d are reduced and the step is
+    *      redone over the LCM of the denominators.
+    *
+    * Returns:
+    *      bool : False if the sum does not fit even after reducing
+    */
+    bool addParts(W n, W d) {
+        W left = 0, right = 0, sum = 0, den = 0;
+        if (d == denominator) {
+            if (!addOverflow(numerator, n, sum)) {
+                numerator = sum;
+                return true;
+            }
+        } else if (!mulOverflow(numerator, d, left) && !mulOverflow(n, denominator, right) &&
+                   !addOverflow(left, right, sum) && !mulOverflow(denominator, d, den)) {
+            numerator = sum;
+            denominator = den;
+            return true;
+        }
+
+        normalize();
+        W g = fastGcd(n, d);
+        if (g > 1) {
+            n /= g;
+            d /= g;
+        }
+        g = fastGcd(denominator, d);
+        W scale1 = d / g;                           // scale1 and scale2 bring both sides to lcm(denominator, d)
+        W scale2 = denominator / g;
+        if (mulOverflow(numerator, scale1, left) || mulOverflow(n, scale2, right) ||
+            addOverflow(left, right, sum) || mulOverflow(denominator, scale1, den)) {
+            return false;
+        }
+        numerator = sum;
+        denominator = den;
+        return true;
+    }
+
+    /**
+    * Private : mulParts
+    *
+    * Description:
+    *      Multiplies by n/d (d > 0). Plain products first; on overflow the
+    *      running value is reduced and the common factors are cancelled
+    *      across the two fractions before multiplying again.
+    *
+    * Returns:
+    *      bool : False if the product does not fit even after reducing
+    */
+    bool mulParts(W n, W d) {
+        W num = 0, den = 0;
+        if (!mulOverflow(numerator, n, num) && !mulOverflow(denominator, d, den)) {
+            numerator = num;
+            denominator = den;
+            return true;
+        }
+
+        normalize();
+        W g1 = fastGcd(numerator, d);
+        W g2 = fastGcd(n, denominator);
+        if (g1 > 1) {
+            numerator /= g1;
+            d /= g1;
+        }
+        if (g2 > 1) {
+            n /= g2;
+            denominator /= g2;
+        }
+        if (mulOverflow(numerator, n, num) || mulOverflow(denominator, d, den)) {
+            return false;
+        }
+        numerator = num;
+        denominator = den;
+        return true;
+    }
+
+public:
+    /**
+    * Constructor
+    *
+    * Description:
+    *      Starts at 0/1, the identity for sums. Start a product from 1/1
+    *      with the second constructor.
+    */
+    FractionAccumulator() : numerator(0), denominator(1), status(FractionStatus::Ok), reductions(0) {}
+
+    explicit FractionAccumulator(const BasicFraction<T>& start)
+        : numerator(0), denominator(1), status(FractionStatus::Ok), reductions(0) {
+        if (!load(start, numerator, denominator)) {
+            status = FractionStatus::Overflow;
+        }
+    }
+
+/**
+* Public : add / sub / mul / div
+*
+* Description:
+*      Apply one step to the running value without reducing it. Nothing
+*      happens once an error has been recorded.
+*
+* Params:
+*      const BasicFraction<T>& f : Value to add, subtract, multiply or divide by
+*/
+    void add(const BasicFraction<T>& f) {
+        W n = 0, d = 0;
+        if (status == FractionStatus::Ok && (!load(f, n, d) || !addParts(n, d))) {
+            status = FractionStatus::Overflow;
+        }
+    }
+
+    void sub(const BasicFraction<T>& f) {
+        W n = 0, d = 0;
+        if (status == FractionStatus::Ok &&
+            (!load(f, n, d) || subOverflow(W(0), n, n) || !addParts(n, d))) {
+            status = FractionStatus::Overflow;
+        }
+    }
+
+    void mul(const BasicFraction<T>& f) {
+        W n = 0, d = 0;
+        if (status == FractionStatus::Ok && (!load(f, n, d) || !mulParts(n, d))) {
+            status = FractionStatus::Overflow;
+        }
+    }
+
+    void div(const BasicFraction<T>& f) {
+        if (status != FractionStatus::Ok) {
+            return;
+        }
+        if (f.getNumerator() == 0) {
+            status = FractionStatus::DivideByZero;
+            return;
+        }
+        BasicFraction<T> reciprocal(f.getDenominator(), f.getNumerator());
+        W n = 0, d = 0;
+        if (!load(reciprocal, n, d) || !mulParts(n, d)) {
+            status = FractionStatus::Overflow;
+        }
+    }
+
+    FractionAccumulator& operator+=(const BasicFraction<T>& f) {
+        add(f);
+        return *this;
+    }
+
+    FractionAccumulator& operator-=(const BasicFraction<T>& f) {
+        sub(f);
+        return *this;
+    }
+
+    FractionAccumulator& operator*=(const BasicFraction<T>& f) {
+        mul(f);
+        return *this;
+    }
+
+    FractionAccumulator& operator/=(const BasicFraction<T>& f) {
+        div(f);
+        return *this;
+    }
+
+/**
+* Public : result
+*
+* Description:
+*      Reduces the running value and stores it in out if it fits in T.
+*
+* Params:
+*      BasicFraction<T>& out : Receives the reduced value
+*
+* Returns:
+*      FractionStatus : The recorded error, Overflow if the reduced value
+*                       does not fit in T, otherwise Ok
+*/
+    FractionStatus result(BasicFraction<T>& out) {
+        if (status != FractionStatus::Ok) {
+            return status;
+        }
+        normalize();
+        if ((W)(T)numerator != numerator || (W)(T)denominator != denominator) {
+            return FractionStatus::Overflow;
+        }
+        out = BasicFraction<T>((T)numerator, (T)denominator);
+        return FractionStatus::Ok;
+    }
+
+    FractionStatus getStatus() const {
+        return status;
+    }
+
+    size_t getReductionCount() const {
+        return reductions;
+    }
+};
+
+#endif
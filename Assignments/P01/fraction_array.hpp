@@ -0,0 +1,420 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            FractionArray Class
+*  Title:            Structure-of-Arrays Fraction Container
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This class stores many fractions as two separate, 64 byte aligned
+*        arrays: one of numerators and one of denominators. The bulk add,
+*        sub, mul, div and equal kernels are plain branch-free loops over
+*        those arrays, which the compiler turns into SIMD code at -O2/-O3.
+*
+*        The arithmetic kernels do not reduce their results. Reducing is a
+*        separate reduce() pass, which is where the GCDs happen; for 32 bit
+*        arrays on AVX2 machines it runs eight lanes of binary GCD at once.
+*        Keeping the two steps apart means a chain of operations only pays
+*        for one reduction at the end.
+*
+*  Usage:
+*       - FractionArray32 a(n), b(n), out(n);
+*       - FractionArray32::add(a, b, out);   // out[i] = a[i] + b[i]
+*       - out.reduce();                      // lowest terms, sign on top
+*
+*  Files:
+*       fraction_array.hpp : header file containing the BasicFractionArray class
+*       fraction.hpp       : Fraction class used for single elements
+*****************************************************************************/
+
+#ifndef FRACTION_ARRAY_HPP
+#define FRACTION_ARRAY_HPP
+
+#include "fraction.hpp"
+#include "int_math.hpp"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * AlignedAllocator
+ *
+ * Description:
+ *      std::vector allocator that hands out memory aligned to Align bytes,
+ *      so every array starts on a cache line and SIMD loads never split one.
+ */
+template <typename T, size_t Align = 64>
+struct AlignedAllocator {
+    typedef T value_type;
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+    template <typename U>
+    struct rebind {
+        typedef AlignedAllocator<U, Align> other;
+    };
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(Align));
+    }
+
+    bool operator==(const AlignedAllocator&) const { return true; }
+    bool operator!=(const AlignedAllocator&) const { return false; }
+};
+
+/**
+ * BasicFractionArray
+ *
+ * Description:
+ *      Fixed size array of fractions stored as separate numerator and
+ *      denominator arrays. The static kernels take whole arrays of the same
+ *      size (checked with assert); out may be the same object as either
+ *      input, so the arithmetic kernels do not declare
+ *      their arrays __restrict.
+ *
+ * Public Methods:
+ *      BasicFractionArray(size_t n)            - n fractions, all 0/1
+ *      size_t size()
+ *      void   resize(size_t n)
+ *      BasicFraction<T> get(size_t i)          - Copy of element i
+ *      void   set(size_t i, const BasicFraction<T>& f)
+ *      size_t fromDoubles(const double* values, T maxDen) - Best fractions for size() doubles
+ *      T*     numerators() / denominators()    - Raw aligned arrays
+ *      void   reduce()                         - Lowest terms, sign on top
+ *      static void add(a, b, out)              - out[i] = a[i] + b[i]
+ *      static void sub(a, b, out)              - out[i] = a[i] - b[i]
+ *      static void mul(a, b, out)              - out[i] = a[i] * b[i]
+ *      static void div(a, b, out)              - out[i] = a[i] / b[i]
+ *      static void equal(a, b, uint8_t* out)   - out[i] = a[i] == b[i]
+ *
+ * Private Methods:
+ *      void reduceScalar(size_t first)         - Portable reduce from first on
+ *      size_t reduceAvx2()                     - AVX2 reduce (int32 only)
+ *
+ * Usage:
+ *      FractionArray64 a(3), b(3);
+ *      a.set(0, Fraction64(1, 2));
+ *      b.set(0, Fraction64(1, 3));
+ *      FractionArray64::add(a, b, a);          // a[0] = 5/6 (unreduced)
+ *      a.reduce();
+ *
+ * Notes:
+ *      - Like the plain Fraction operators, the kernels wrap on overflow.
+ *        Inputs below 2^15 (int32) or 2^31 (int64) never overflow in one
+ *        operation.
+ *      - Dividing by a zero fraction leaves a denominator of 0 in that slot.
+ */
+template <typename T>
+class BasicFractionArray {
+    typedef typename UnsignedOf<T>::type U;
+    std::vector<T, AlignedAllocator<T> > nums;      // Numerators
+    std::vector<T, AlignedAllocator<T> > dens;      // Denominators
+
+    /**
+    * Private : reduceScalar
+    *
+    * Description:
+    *      Reduces elements first..size()-1 one at a time with fastGcd.
+    */
+    void reduceScalar(size_t first) {
+        T* n = nums.data();
+        T* d = dens.data();
+        for (size_t i = first; i < nums.size(); ++i) {
+            T g = fastGcd(n[i], d[i]);
+            if (g > 1) {
+                n[i] /= g;
+                d[i] /= g;
+            }
+            if (d[i] < 0) {
+                n[i] = (T)(U(0) - (U)n[i]);
+                d[i] = (T)(U(0) - (U)d[i]);
+            }
+        }
+    }
+
+#if defined(__AVX2__)
+    /**
+    * Private : reduceAvx2
+    *
+    * Description:
+    *      Binary GCD on eight int32 lanes at once. All lanes run the loop in
+    *      lockstep until every lane is done; finished lanes are masked off.
+    *      AVX2 has no vector count-trailing-zeros, so it is read from the
+    *      float exponent of x & -x. The exact division by the GCD goes
+    *      through double, which holds every int32 exactly.
+    *
+    * Returns:
+    *      size_t : Number of elements handled (a multiple of 8)
+    */
+    size_t reduceAvx2() {
+        const size_t count = nums.size() & ~size_t(7);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i bias = _mm256_set1_epi32(127);
+        const __m256i expMask = _mm256_set1_epi32(0xFF);
+        int32_t* n = reinterpret_cast<int32_t*>(nums.data());
+        int32_t* d = reinterpret_cast<int32_t*>(dens.data());
+
+        // ctz of every lane; lanes holding 0 come out negative, which the
+        // variable shifts treat as "shift everything out"
+        auto ctz = [&](__m256i x) {
+            __m256i low = _mm256_and_si256(x, _mm256_sub_epi32(zero, x));
+            __m256i bits = _mm256_castps_si256(_mm256_cvtepi32_ps(low));
+            return _mm256_sub_epi32(_mm256_and_si256(_mm256_srli_epi32(bits, 23), expMask), bias);
+        };
+
+        for (size_t i = 0; i < count; i += 8) {
+            __m256i vn = _mm256_load_si256(reinterpret_cast<const __m256i*>(n + i));
+            __m256i vd = _mm256_load_si256(reinterpret_cast<const __m256i*>(d + i));
+            __m256i b = _mm256_abs_epi32(vd);
+            __m256i a = _mm256_abs_epi32(vn);
+            a = _mm256_blendv_epi8(a, b, _mm256_cmpeq_epi32(a, zero));   // gcd(0, b) == gcd(b, b)
+
+            __m256i shift = ctz(_mm256_or_si256(a, b));
+            a = _mm256_srlv_epi32(a, ctz(a));
+            __m256i done = _mm256_cmpeq_epi32(b, zero);
+            while (_mm256_movemask_epi8(done) != -1) {
+                b = _mm256_srlv_epi32(b, ctz(b));
+                __m256i lo = _mm256_min_epu32(a, b);
+                __m256i hi = _mm256_max_epu32(a, b);
+                a = _mm256_blendv_epi8(lo, a, done);
+                b = _mm256_blendv_epi8(_mm256_sub_epi32(hi, lo), zero, done);
+                done = _mm256_cmpeq_epi32(b, zero);
+            }
+            __m256i g = _mm256_sllv_epi32(a, shift);
+            g = _mm256_blendv_epi8(g, one, _mm256_cmpeq_epi32(g, zero));
+
+            // Divide by g four lanes at a time in double precision
+            __m256d g0 = _mm256_cvtepi32_pd(_mm256_castsi256_si128(g));
+            __m256d g1 = _mm256_cvtepi32_pd(_mm256_extracti128_si256(g, 1));
+            __m128i n0 = _mm256_cvttpd_epi32(
+                _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(vn)), g0));
+            __m128i n1 = _mm256_cvttpd_epi32(
+                _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(vn, 1)), g1));
+            __m128i d0 = _mm256_cvttpd_epi32(
+                _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(vd)), g0));
+            __m128i d1 = _mm256_cvttpd_epi32(
+                _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(vd, 1)), g1));
+            vn = _mm256_set_m128i(n1, n0);
+            vd = _mm256_set_m128i(d1, d0);
+
+            // Move the sign to the numerator: x = (x ^ s) - s with s = d >> 31
+            __m256i sign = _mm256_srai_epi32(vd, 31);
+            vn = _mm256_sub_epi32(_mm256_xor_si256(vn, sign), sign);
+            vd = _mm256_sub_epi32(_mm256_xor_si256(vd, sign), sign);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(n + i), vn);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(d + i), vd);
+        }
+        return count;
+    }
+#endif
+
+public:
+    /**
+    * Constructor
+    *
+    * Params:
+    *      size_t n : Number of fractions (all start as 0/1)
+    */
+    explicit BasicFractionArray(size_t n = 0) : nums(n, T(0)), dens(n, T(1)) {}
+
+    size_t size() const { return nums.size(); }
+
+    void resize(size_t n) {
+        nums.resize(n, T(0));
+        dens.resize(n, T(1));
+    }
+
+    BasicFraction<T> get(size_t i) const {
+        return BasicFraction<T>(nums[i], dens[i] == 0 ? T(1) : dens[i]);
+    }
+
+    void set(size_t i, const BasicFraction<T>& f) {
+        nums[i] = f.getNumerator();
+        dens[i] = f.getDenominator();
+    }
+
+    /**
+    * Public : fromDoubles
+    *
+    * Description:
+    *      Fills every element with the closest fraction to values[i] whose
+    *      denominator is at most maxDen, using BasicFraction::fromDouble.
+    *      Elements that cannot be converted (NaN, infinity, too large) are
+    *      set to 0/1.
+    *
+    * Params:
+    *      const double* values : size() doubles
+    *      T maxDen             : Largest denominator allowed
+    *
+    * Returns:
+    *      size_t : Number of values that could not be converted
+    */
+    size_t fromDoubles(const double* values, T maxDen) {
+        size_t failed = 0;
+        BasicFraction<T> f;
+        for (size_t i = 0; i < nums.size(); ++i) {
+            failed += BasicFraction<T>::fromDouble(values[i], maxDen, f) != FractionStatus::Ok;
+            nums[i] = f.getNumerator();
+            dens[i] = f.getDenominator();
+        }
+        return failed;
+    }
+
+    T* numerators() { return nums.data(); }
+    T* denominators() { return dens.data(); }
+    const T* numerators() const { return nums.data(); }
+    const T* denominators() const { return dens.data(); }
+
+    /**
+    * Public : reduce
+    *
+    * Description:
+    *      Puts every element in lowest terms with a positive denominator.
+    *      Uses the AVX2 path for int32 arrays when it is compiled in.
+    *
+    * Returns:
+    *      void
+    */
+    void reduce() {
+        size_t done = 0;
+#if defined(__AVX2__)
+        if constexpr (sizeof(T) == 4) {
+            done = reduceAvx2();
+        }
+#endif
+        reduceScalar(done);
+    }
+
+    /**
+    * Public : add / sub
+    *
+    * Description:
+    *      out[i] = a[i] +/- b[i] as n1*d2 +/- n2*d1 over d1*d2, unreduced.
+    *      The math is done in the unsigned type so overflow wraps instead of
+    *      being undefined, which also keeps the loop vectorizable.
+    */
+    static void add(const BasicFractionArray& a, const BasicFractionArray& b, BasicFractionArray& out) {
+        assert(b.size() == a.size());
+        const size_t count = a.size();
+        out.resize(count);
+        const T* an = a.nums.data();
+        const T* ad = a.dens.data();
+        const T* bn = b.nums.data();
+        const T* bd = b.dens.data();
+        T* on = out.nums.data();
+        T* od = out.dens.data();
+        for (size_t i = 0; i < count; ++i) {
+            U n = (U)an[i] * (U)bd[i] + (U)bn[i] * (U)ad[i];
+            U d = (U)ad[i] * (U)bd[i];
+            on[i] = (T)n;
+            od[i] = (T)d;
+        }
+    }
+
+    static void sub(const BasicFractionArray& a, const BasicFractionArray& b, BasicFractionArray& out) {
+        assert(b.size() == a.size());
+        const size_t count = a.size();
+        out.resize(count);
+        const T* an = a.nums.data();
+        const T* ad = a.dens.data();
+        const T* bn = b.nums.data();
+        const T* bd = b.dens.data();
+        T* on = out.nums.data();
+        T* od = out.dens.data();
+        for (size_t i = 0; i < count; ++i) {
+            U n = (U)an[i] * (U)bd[i] - (U)bn[i] * (U)ad[i];
+            U d = (U)ad[i] * (U)bd[i];
+            on[i] = (T)n;
+            od[i] = (T)d;
+        }
+    }
+
+    /**
+    * Public : mul / div
+    *
+    * Description:
+    *      out[i] = a[i] * b[i] or a[i] / b[i], unreduced. Division is
+    *      multiplication by the flipped fraction; reduce() fixes the sign.
+    */
+    static void mul(const BasicFractionArray& a, const BasicFractionArray& b, BasicFractionArray& out) {
+        assert(b.size() == a.size());
+        const size_t count = a.size();
+        out.resize(count);
+        const T* an = a.nums.data();
+        const T* ad = a.dens.data();
+        const T* bn = b.nums.data();
+        const T* bd = b.dens.data();
+        T* on = out.nums.data();
+        T* od = out.dens.data();
+        for (size_t i = 0; i < count; ++i) {
+            U n = (U)an[i] * (U)bn[i];
+            U d = (U)ad[i] * (U)bd[i];
+            on[i] = (T)n;
+            od[i] = (T)d;
+        }
+    }
+
+    static void div(const BasicFractionArray& a, const BasicFractionArray& b, BasicFractionArray& out) {
+        assert(b.size() == a.size());
+        const size_t count = a.size();
+        out.resize(count);
+        const T* an = a.nums.data();
+        const T* ad = a.dens.data();
+        const T* bn = b.nums.data();
+        const T* bd = b.dens.data();
+        T* on = out.nums.data();
+        T* od = out.dens.data();
+        for (size_t i = 0; i < count; ++i) {
+            U n = (U)an[i] * (U)bd[i];
+            U d = (U)ad[i] * (U)bn[i];
+            on[i] = (T)n;
+            od[i] = (T)d;
+        }
+    }
+
+    /**
+    * Public : equal
+    *
+    * Description:
+    *      out[i] = 1 if a[i] == b[i], else 0. The cross products are formed
+    *      in a type twice as wide as T, so the test is exact and works on
+    *      unreduced fractions.
+    *
+    * Params:
+    *      const BasicFractionArray& a : Left operands
+    *      const BasicFractionArray& b : Right operands
+    *      uint8_t* out                : Receives a.size() flags
+    */
+    static void equal(const BasicFractionArray& a, const BasicFractionArray& b, uint8_t* out) {
+        typedef typename WideOf<T>::type W;
+        assert(b.size() == a.size());
+        const size_t count = a.size();
+        const T* __restrict an = a.nums.data();
+        const T* __restrict ad = a.dens.data();
+        const T* __restrict bn = b.nums.data();
+        const T* __restrict bd = b.dens.data();
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = (uint8_t)((W)an[i] * (W)bd[i] == (W)bn[i] * (W)ad[i]);
+        }
+    }
+};
+
+typedef BasicFractionArray<int32_t> FractionArray32;
+typedef BasicFractionArray<int64_t> FractionArray64;
+
+#endif
@@ -0,0 +1,285 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            Fraction Benchmark
+*  Title:            Fraction Class Benchmark Suite
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This program times every part of the Fraction pipeline: building a
+*        fraction, each operator (+ - * / ==), printing, parsing a line and
+*        evaluating a whole line with the expression engine. The "arr+" and
+*        "arr*" columns time the same additions and multiplications done a
+*        whole FractionArray64 at a time (kernel plus reduce), per element,
+*        for comparison with the scalar "+" and "*" columns. Each benchmark
+*        runs on several operand distributions and input sizes, over data
+*        built up front from a fixed seed, and the best of several rounds is
+*        reported. Compile with -DFRACTION_GCD_EUCLID to compare the GCD
+*        backends on the full pipeline.
+*
+*  Usage:
+*       - $ ./fraction_bench [rounds] [size ...]
+*       - rounds defaults to 5, sizes to 1000 100000 1000000
+*
+*  Files:
+*       fraction_bench.cpp  : benchmark driver
+*       fraction.hpp        : Fraction class being measured
+*       fraction_parser.hpp : tokenizer being measured
+*       expression.hpp      : expression engine being measured
+*****************************************************************************/
+
+#include "expression.hpp"
+#include "fraction.hpp"
+#include "fraction_array.hpp"
+#include "fraction_parser.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Workload
+ *
+ * Description:
+ *      Pre-generated operands for one distribution and size. Every right
+ *      hand numerator is non-zero so division never fails, and lines holds
+ *      the same operands written as "a/b + c/d" for the parsing benchmarks.
+ */
+struct Workload {
+    vector<int64_t> n1, d1, n2, d2;     // Operands as raw integers
+    vector<Fraction64> left, right;     // The same operands as fractions
+    vector<string> lines;               // The same operands as input lines
+};
+
+/**
+ * makeWorkload
+ *
+ * Description:
+ *      Builds count operand pairs from the named distribution with a fixed
+ *      seed so every run is comparable.
+ *
+ * Params:
+ *      const string& kind : "small", "large" or "equal"
+ *      size_t count       : Number of operand pairs
+ *
+ * Returns:
+ *      Workload : The operands in every form the benchmarks need
+ */
+Workload makeWorkload(const string& kind, size_t count) {
+    mt19937_64 rng(2143);
+    Workload w;
+    for (size_t i = 0; i < count; i++) {
+        int64_t a, b, c, d;
+        if (kind == "small") {                          // typical hand-written fractions
+            a = (int64_t)(rng() % 1000) + 1;
+            b = (int64_t)(rng() % 1000) + 1;
+            c = (int64_t)(rng() % 1000) + 1;
+            d = (int64_t)(rng() % 1000) + 1;
+        } else if (kind == "large") {                   // 31 bit values, products still fit in 64 bits
+            a = (int64_t)(rng() >> 33) + 1;
+            b = (int64_t)(rng() >> 33) + 1;
+            c = (int64_t)(rng() >> 33) + 1;
+            d = (int64_t)(rng() >> 33) + 1;
+        } else {                                        // equal values in different terms
+            a = (int64_t)(rng() % 1000) + 1;
+            b = (int64_t)(rng() % 1000) + 1;
+            int64_t k = (int64_t)(rng() % 1000) + 2;
+            c = a * k;
+            d = b * k;
+        }
+        if (rng() % 8 == 0) {
+            a = -a;
+        }
+        w.n1.push_back(a);
+        w.d1.push_back(b);
+        w.n2.push_back(c);
+        w.d2.push_back(d);
+        w.left.push_back(Fraction64(a, b));
+        w.right.push_back(Fraction64(c, d));
+        w.lines.push_back(to_string(a) + "/" + to_string(b) + " + " + to_string(c) + "/" + to_string(d));
+    }
+    return w;
+}
+
+/**
+ * keepAlive
+ *
+ * Description:
+ *      Tells the compiler the value is used, so timed loops are not hoisted
+ *      or thrown away.
+ */
+inline void keepAlive(int64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(value) : "memory");
+#else
+    volatile int64_t sink = value;
+    (void)sink;
+#endif
+}
+
+/**
+ * timeBest
+ *
+ * Description:
+ *      Runs body once per item, rounds times, and returns the best time per
+ *      item in nanoseconds. body returns a value that is summed and kept
+ *      alive so the work cannot be optimized away.
+ *
+ * Params:
+ *      size_t count : Items per round
+ *      int rounds   : Times to repeat the run
+ *      Body body    : Callable taking the item index
+ *
+ * Returns:
+ *      double : Best nanoseconds per item
+ */
+template <typename Body>
+double timeBest(size_t count, int rounds, Body body) {
+    double best = 1e300;
+    for (int r = 0; r < rounds; r++) {
+        int64_t sum = 0;
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < count; i++) {
+            sum += body(i);
+        }
+        keepAlive(sum);
+        auto stop = chrono::steady_clock::now();
+        double ns = chrono::duration<double, nano>(stop - start).count() / count;
+        if (ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+/**
+ * timeBestBatch
+ *
+ * Description:
+ *      Like timeBest, but body handles all count items in one call (a whole
+ *      array operation).
+ *
+ * Returns:
+ *      double : Best nanoseconds per item
+ */
+template <typename Body>
+double timeBestBatch(size_t count, int rounds, Body body) {
+    double best = 1e300;
+    for (int r = 0; r < rounds; r++) {
+        auto start = chrono::steady_clock::now();
+        keepAlive(body());
+        auto stop = chrono::steady_clock::now();
+        double ns = chrono::duration<double, nano>(stop - start).count() / count;
+        if (ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    int rounds = argc > 1 ? atoi(argv[1]) : 5;
+    vector<size_t> sizes;
+    for (int i = 2; i < argc; i++) {
+        sizes.push_back(strtoull(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) {
+        sizes = {1000, 100000, 1000000};
+    }
+    if (rounds <= 0) {
+        cerr << "Usage: " << argv[0] << " [rounds] [size ...]\n";
+        return 1;
+    }
+
+    const char* names[] = {"construct", "+", "-", "*", "/", "==", "print", "parse", "evaluate", "arr+", "arr*"};
+    const char* kinds[] = {"small", "large", "equal"};
+    cout << "rounds=" << rounds << " (ns per operation, best round)\n";
+    cout << left << setw(8) << "operands" << right << setw(9) << "size";
+    for (const char* name : names) {
+        cout << setw(10) << name;
+    }
+    cout << "\n";
+
+    for (const char* kind : kinds) {
+        for (size_t size : sizes) {
+            if (size == 0) {
+                continue;
+            }
+            Workload w = makeWorkload(kind, size);
+            vector<double> times;
+
+            times.push_back(timeBest(size, rounds, [&](size_t i) {
+                return Fraction64(w.n1[i], w.d1[i]).getNumerator();
+            }));
+            times.push_back(timeBest(size, rounds, [&](size_t i) {
+                return (w.left[i] + w.right[i]).getDenominator();
+            }));
+            times.push_back(timeBest(size, rounds, [&](size_t i) {
+                return (w.left[i] - w.right[i]).getDenominator();
+            }));
+            times.push_back(timeBest(size, rounds, [&](size_t i) {
+                return (w.left[i] * w.right[i]).getDenominator();
+            }));
+            times.push_back(timeBest(size, rounds, [&](size_t i) {
+                return (w.left[i] / w.right[i]).getDenominator();
+            }));
+            times.push_back(timeBest(size, rounds, [&](size_t i) {
+                return (int64_t)(w.left[i] == w.right[i]);
+            }));
+            ostringstream out;
+            times.push_back(timeBest(size, rounds, [&](size_t i) {
+                if (i == 0) {
+                    out.str("");
+                }
+                out << w.left[i] << "\n";
+                return (int64_t)1;
+            }));
+            times.push_back(timeBest(size, rounds, [&](size_t i) {
+                const string& line = w.lines[i];
+                FractionParser parser(line.data(), line.data() + line.size(), i + 1);
+                ExpressionToken<int64_t> expr;
+                parser.parseExpression(expr);
+                return expr.left.numerator + expr.right.denominator;
+            }));
+            ExpressionEngine<int64_t> engine;
+            times.push_back(timeBest(size, rounds, [&](size_t i) {
+                const string& line = w.lines[i];
+                ExpressionResult<int64_t> result;
+                engine.evaluate(line.data(), line.data() + line.size(), i + 1, result);
+                return result.value.getDenominator();
+            }));
+
+            FractionArray64 a(size), b(size), sums(size);
+            for (size_t i = 0; i < size; i++) {
+                a.set(i, w.left[i]);
+                b.set(i, w.right[i]);
+            }
+            times.push_back(timeBestBatch(size, rounds, [&]() {
+                FractionArray64::add(a, b, sums);
+                sums.reduce();
+                return sums.denominators()[size - 1];
+            }));
+            times.push_back(timeBestBatch(size, rounds, [&]() {
+                FractionArray64::mul(a, b, sums);
+                sums.reduce();
+                return sums.denominators()[size - 1];
+            }));
+
+            cout << fixed << setprecision(2) << left << setw(8) << kind << right << setw(9) << size;
+            for (double t : times) {
+                cout << setw(10) << t;
+            }
+            cout << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,219 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            Fraction Client
+*  Title:            Client and Load Tester for the P01 Socket Server
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This program talks to "./P01 --serve PATH". With one client and one
+*        pass it is a plain client: standard input is sent to the server and
+*        the answers are printed, so the output matches "./P01 < input".
+*        With more clients or passes it becomes a load tester: every client
+*        connects at the same time and sends the whole input the given
+*        number of times while reading answers back on a second thread, and
+*        the line rate and time to the first answer are reported for each
+*        client and in total. The answers themselves are only counted.
+*
+*  Usage:
+*       - $ ./P01 --serve /tmp/p01.sock &
+*       - $ ./fraction_client /tmp/p01.sock < input
+*       - $ ./fraction_client /tmp/p01.sock 8 100 < input    // 8 clients, 100 passes each
+*
+*  Files:
+*       fraction_client.cpp : client program
+*       fraction_server.hpp : the server it talks to
+*****************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+typedef chrono::steady_clock Clock;
+
+/**
+ * ClientReport
+ *
+ * Description:
+ *      What one load test client saw.
+ */
+struct ClientReport {
+    bool ok;                    // Connected and finished without an error
+    size_t bytes;               // Bytes of answers received
+    double firstMillis;         // Time from connecting to the first answer byte
+    double totalMillis;         // Time from connecting to the server closing the connection
+};
+
+/**
+ * connectTo
+ *
+ * Description:
+ *      Opens a stream connection to the Unix socket at path.
+ *
+ * Returns:
+ *      int : Connected socket, or -1 (with a message on stderr)
+ */
+int connectTo(const string& path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        cerr << "Error: socket path is too long\n";
+        return -1;
+    }
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+        cerr << "Error: " << path << ": " << strerror(errno) << "\n";
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * sendAll
+ *
+ * Description:
+ *      Writes all of data to fd, retrying short writes.
+ *
+ * Returns:
+ *      bool : False if the connection failed
+ */
+bool sendAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= (size_t)sent;
+    }
+    return true;
+}
+
+/**
+ * runClient
+ *
+ * Description:
+ *      Sends input passes times on one connection while a second thread
+ *      reads the answers, then shuts down the sending side and waits for
+ *      the server to finish. If echo is set the answers are copied to
+ *      standard output.
+ *
+ * Params:
+ *      const string& path  : Server socket
+ *      const string& input : Lines to send (ending in '\n')
+ *      size_t passes       : How many times to send input
+ *      bool echo           : Print the answers
+ *
+ * Returns:
+ *      ClientReport : Byte count and timings
+ */
+ClientReport runClient(const string& path, const string& input, size_t passes, bool echo) {
+    ClientReport report = {false, 0, 0.0, 0.0};
+    Clock::time_point start = Clock::now();
+    int fd = connectTo(path);
+    if (fd < 0) {
+        return report;
+    }
+    bool sent = true;
+    thread sender([&] {
+        for (size_t i = 0; i < passes && sent; i++) {
+            sent = sendAll(fd, input.data(), input.size());
+        }
+        shutdown(fd, SHUT_WR);
+    });
+
+    vector<char> buffer(1 << 16);
+    ssize_t got;
+    while ((got = read(fd, buffer.data(), buffer.size())) != 0) {
+        if (got < 0 && errno == EINTR) {
+            continue;
+        } else if (got < 0) {
+            break;
+        }
+        if (report.bytes == 0) {
+            report.firstMillis = chrono::duration<double, milli>(Clock::now() - start).count();
+        }
+        report.bytes += (size_t)got;
+        if (echo) {
+            fwrite(buffer.data(), 1, (size_t)got, stdout);
+        }
+    }
+    sender.join();
+    close(fd);
+    report.totalMillis = chrono::duration<double, milli>(Clock::now() - start).count();
+    report.ok = sent && got == 0;
+    return report;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " SOCKET [clients] [passes] < input\n";
+        return 1;
+    }
+    string path = argv[1];
+    size_t clients = argc > 2 ? strtoul(argv[2], nullptr, 10) : 1;
+    size_t passes = argc > 3 ? strtoul(argv[3], nullptr, 10) : 1;
+    if (clients == 0 || passes == 0) {
+        cerr << "Error: clients and passes must be at least 1\n";
+        return 1;
+    }
+
+    string input((istreambuf_iterator<char>(cin)), istreambuf_iterator<char>());
+    if (!input.empty() && input.back() != '\n') {
+        input += '\n';                                  // the server only answers complete lines
+    }
+    if (clients == 1 && passes == 1) {
+        return runClient(path, input, 1, true).ok ? 0 : 1;
+    }
+
+    size_t lines = 0;                                   // lines counts the non-blank lines in one pass
+    for (size_t i = 0, start = 0; i < input.size(); i++) {
+        if (input[i] == '\n') {
+            lines += input.find_first_not_of(" \t\r", start) < i;
+            start = i + 1;
+        }
+    }
+
+    vector<ClientReport> reports(clients);
+    vector<thread> workers;
+    Clock::time_point start = Clock::now();
+    for (size_t c = 0; c < clients; c++) {
+        workers.emplace_back([&, c] { reports[c] = runClient(path, input, passes, false); });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+    size_t failed = 0;
+    for (size_t c = 0; c < clients; c++) {
+        const ClientReport& r = reports[c];
+        failed += !r.ok;
+        printf("client %zu: %s, %zu bytes, first answer %.2f ms, done %.1f ms, %.0f lines/s\n", c + 1,
+               r.ok ? "ok" : "FAILED", r.bytes, r.firstMillis, r.totalMillis,
+               r.totalMillis > 0 ? lines * passes / (r.totalMillis / 1000.0) : 0.0);
+    }
+    printf("total: %zu clients, %zu lines in %.3f s, %.0f lines/s, %zu failed\n", clients,
+           lines * passes * clients, seconds, lines * passes * clients / seconds, failed);
+    return failed == 0 ? 0 : 1;
+}
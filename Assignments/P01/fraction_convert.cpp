@@ -0,0 +1,175 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            Record Converter
+*  Title:            Text and Binary Fraction Record Converter
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This program converts between the text input the P01 driver reads
+*        ("a/b op c/d", one per line) and the packed binary records in
+*        fraction_record.hpp, and prints binary result files as text. A job
+*        set is converted once with to-binary and can then be run any number
+*        of times with "./P01 --binary" without parsing text again.
+*
+*  Usage:
+*       - $ ./fraction_convert to-binary < input > jobs.bin
+*       - $ ./fraction_convert to-text < jobs.bin > input
+*       - $ ./fraction_convert results < results.bin
+*       - Text lines that are not "a/b op c/d" with 64 bit values are
+*         reported on stderr and skipped.
+*
+*  Files:
+*       fraction_convert.cpp : converter program
+*       fraction_record.hpp  : binary record format
+*       fraction_parser.hpp  : tokenizer used for the text side
+*       output_buffer.hpp    : buffered writer for the output
+*****************************************************************************/
+
+#include "fraction_parser.hpp"
+#include "fraction_record.hpp"
+#include "output_buffer.hpp"
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * toBinary
+ *
+ * Description:
+ *      Parses text jobs from standard input and writes a job file.
+ *
+ * Returns:
+ *      int : Exit code (0 even if some lines were skipped)
+ */
+int toBinary() {
+    MappedFile input(STDIN_FILENO);
+    OutputBuffer out(1 << 20);
+    char packed[recordHeaderSize > jobRecordSize ? recordHeaderSize : jobRecordSize];
+    writeHeader(packed, RecordKind::Jobs);
+    out << string_view(packed, recordHeaderSize);
+
+    size_t line = 0, written = 0, skipped = 0;
+    const char* p = input.data();
+    const char* end = p + input.size();
+    while (p < end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (eol == nullptr) {
+            eol = end;
+        }
+        ++line;
+        FractionParser parser(p, eol, line);
+        ExpressionToken<int64_t> expr;
+        JobRecord job;
+        if (parser.atEnd()) {
+            // blank line
+        } else if (!parser.parseExpression(expr)) {
+            cerr << parser.getError() << "\n";
+            ++skipped;
+        } else if (!recordOpFromText(expr.op, job.op)) {
+            cerr << "Line " << line << ": operator \"" << expr.op << "\" has no binary code\n";
+            ++skipped;
+        } else {
+            job.n1 = expr.left.numerator;
+            job.d1 = expr.left.denominator;
+            job.n2 = expr.right.numerator;
+            job.d2 = expr.right.denominator;
+            encodeJob(packed, job);
+            out << string_view(packed, jobRecordSize);
+            ++written;
+            if (out.size() >= (1 << 20)) {
+                out.writeTo(STDOUT_FILENO);
+            }
+        }
+        p = eol + 1;
+    }
+    out.writeTo(STDOUT_FILENO);
+    cerr << written << " records written, " << skipped << " lines skipped\n";
+    return 0;
+}
+
+/**
+ * toText
+ *
+ * Description:
+ *      Prints every record of a job file as "n1/d1 op n2/d2".
+ */
+int toText() {
+    MappedFile input(STDIN_FILENO);
+    RecordHeader header;
+    if (!readHeader(input.data(), input.size(), header) || header.kind != RecordKind::Jobs) {
+        cerr << "Error: standard input is not a binary job file.\n";
+        return 1;
+    }
+    OutputBuffer out(1 << 20);
+    for (size_t at = recordHeaderSize; at + jobRecordSize <= input.size(); at += jobRecordSize) {
+        JobRecord job = decodeJob(input.data() + at);
+        out << job.n1 << '/' << job.d1 << ' ' << recordOpSymbol(job.op) << ' ' << job.n2 << '/' << job.d2 << '\n';
+        if (out.size() >= (1 << 20)) {
+            out.writeTo(STDOUT_FILENO);
+        }
+    }
+    out.writeTo(STDOUT_FILENO);
+    return 0;
+}
+
+/**
+ * resultsToText
+ *
+ * Description:
+ *      Prints every record of a result file with the driver's wording: the
+ *      zero denominator warning if it was flagged, then the fraction, the
+ *      comparison or the error.
+ */
+int resultsToText() {
+    MappedFile input(STDIN_FILENO);
+    RecordHeader header;
+    if (!readHeader(input.data(), input.size(), header) || header.kind != RecordKind::Results) {
+        cerr << "Error: standard input is not a binary result file.\n";
+        return 1;
+    }
+    OutputBuffer out(1 << 20);
+    for (size_t at = recordHeaderSize; at + resultRecordSize <= input.size(); at += resultRecordSize) {
+        ResultRecord result = decodeResult(input.data() + at);
+        if (result.status & zeroDenominatorFlag) {
+            out << "You cannot divide by 0. The denominator will be set to 1.\n";
+        }
+        uint8_t status = result.status & statusMask;
+        if (status == unknownOpStatus) {
+            out << "Error: Unknown operator code.\n";
+        } else if ((FractionStatus)status == FractionStatus::DivideByZero) {
+            out << "Error: Division by zero.\n";
+        } else if ((FractionStatus)status == FractionStatus::Overflow) {
+            out << "Error: Result does not fit in 64 bit integers.\n";
+        } else if (result.status & comparisonFlag) {
+            out << (result.numerator != 0 ? "The fractions are equal. \n" : "The fractions are not equal. \n");
+        } else {
+            out << result.numerator << '/' << result.denominator << '\n';
+        }
+        if (out.size() >= (1 << 20)) {
+            out.writeTo(STDOUT_FILENO);
+        }
+    }
+    out.writeTo(STDOUT_FILENO);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    string mode = argc > 1 ? argv[1] : "";
+    if (mode == "to-binary") {
+        return toBinary();
+    } else if (mode == "to-text") {
+        return toText();
+    } else if (mode == "results") {
+        return resultsToText();
+    }
+    cerr << "Usage: " << argv[0] << " to-binary|to-text|results < in > out\n";
+    return 1;
+}
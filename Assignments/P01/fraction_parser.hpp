@@ -0,0 +1,393 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            FractionParser Class
+*  Title:            Zero Allocation Fraction Tokenizer
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This class tokenizes "a/b op c/d" expressions straight out of a raw
+*        byte buffer. Integers are signed, any number of digits wide (as long
+*        as they fit the target type) and bare integers are read as n/1.
+*        Spaces are allowed around the slash. Nothing is copied: operators
+*        come back as std::string_view into the buffer and numbers are built
+*        digit by digit, so parsing never touches the allocator.
+*
+*  Usage:
+*       - Create a FractionParser over a line (or any byte range)
+*       - Call parseExpression() to read "fraction op fraction"
+*       - On failure, getError() holds the line, column and a message
+*
+*  Files:
+*       fraction_parser.hpp : header file containing the FractionParser class
+*****************************************************************************/
+
+#ifndef FRACTION_PARSER_HPP
+#define FRACTION_PARSER_HPP
+
+#include <cctype>
+#include <cstddef>
+#include <limits>
+#include <ostream>
+#include <string_view>
+
+/**
+ * ParseError
+ *
+ * Description:
+ *      Where and why parsing stopped. Line and column are both 1-based.
+ *      message always points at a string literal.
+ */
+struct ParseError {
+    size_t line;
+    size_t column;
+    const char* message;
+};
+
+/**
+ * Overload output operator (<<) for printing parse errors. Works with any
+ * stream-like type, including std::ostream and OutputBuffer.
+ */
+template <typename Stream>
+Stream& operator<<(Stream& os, const ParseError& err) {
+    os << "Parse error at line " << err.line << ", column " << err.column << ": " << err.message;
+    return os;
+}
+
+/**
+ * FractionToken
+ *
+ * Description:
+ *      One parsed fraction plus the span of text it came from, so callers
+ *      can echo the input exactly as it was written.
+ */
+template <typename T>
+struct FractionToken {
+    T numerator;
+    T denominator;
+    std::string_view text;
+};
+
+/**
+ * ExpressionToken
+ *
+ * Description:
+ *      A parsed "left op right" expression.
+ */
+template <typename T>
+struct ExpressionToken {
+    FractionToken<T> left;
+    std::string_view op;
+    FractionToken<T> right;
+};
+
+/**
+ * FractionParser
+ *
+ * Description:
+ *      Cursor over a byte range. Every parse method skips leading spaces and
+ *      tabs, reads one item and leaves the cursor just after it. When a parse
+ *      method returns false the cursor is left at the offending character and
+ *      getError() describes the problem.
+ *
+ * Public Methods:
+ *      FractionParser(const char* begin, const char* end, size_t line)
+ *      bool parseInteger(T& value)                 - Signed decimal integer
+ *      bool parseFraction(FractionToken<T>& frac)  - "a/b" or "a"
+ *      bool parseOperator(std::string_view& op)    - Run of punctuation
+ *      bool parseExpression(ExpressionToken<T>& e) - "fraction op fraction"
+ *      bool atEnd()                                - Only blanks remain
+ *      char peek() / void advance(size_t count)    - Look at / consume characters
+ *      const char* getPosition()
+ *      bool setError(const char* at, const char* message)
+ *      const ParseError& getError()
+ *
+ * Private Methods:
+ *      void skipBlanks()
+ *      bool fail(const char* at, const char* message)
+ *
+ * Usage:
+ *      FractionParser parser(line.data(), line.data() + line.size(), 1);
+ *      ExpressionToken<int> expr;
+ *      if (!parser.parseExpression(expr))
+ *          cout << parser.getError() << endl;
+ */
+class FractionParser {
+    const char* begin;          // Start of the buffer (column 1)
+    const char* cursor;         // Next unread character
+    const char* end;            // One past the last character
+    size_t line;                // Line number reported in errors
+    ParseError error;           // Last error
+
+    /**
+    * Private : skipBlanks
+    *
+    * Description:
+    *      Moves the cursor past spaces, tabs and carriage returns.
+    */
+    void skipBlanks() {
+        while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) {
+            ++cursor;
+        }
+    }
+
+    /**
+    * Private : fail
+    *
+    * Description:
+    *      Records an error at the given position.
+    *
+    * Returns:
+    *      bool : Always false, so callers can "return fail(...)"
+    */
+    bool fail(const char* at, const char* message) {
+        cursor = at;
+        error.line = line;
+        error.column = (size_t)(at - begin) + 1;
+        error.message = message;
+        return false;
+    }
+
+    static bool isDigit(char ch) {
+        return ch >= '0' && ch <= '9';
+    }
+
+    static bool isOperatorChar(char ch) {
+        return std::ispunct((unsigned char)ch) != 0;
+    }
+
+public:
+    /**
+    * Constructor
+    *
+    * Params:
+    *      const char* begin : First byte to parse
+    *      const char* end   : One past the last byte to parse
+    *      size_t line       : Line number used in error reports
+    */
+    FractionParser(const char* begin, const char* end, size_t line = 1)
+        : begin(begin), cursor(begin), end(end), line(line), error{line, 1, ""} {}
+
+    /**
+    * Public : parseInteger
+    *
+    * Description:
+    *      Reads an optionally signed decimal integer into value. Overflow is
+    *      detected before it happens, so T can be any signed integer type
+    *      (including __int128) and the full range of T is accepted.
+    *
+    * Params:
+    *      T& value : Receives the parsed integer
+    *
+    * Returns:
+    *      bool : True on success
+    */
+    template <typename T>
+    bool parseInteger(T& value) {
+        skipBlanks();
+        const char* start = cursor;
+        bool negative = false;
+        if (cursor < end && (*cursor == '-' || *cursor == '+')) {
+            negative = (*cursor == '-');
+            ++cursor;
+        }
+        if (cursor == end || !isDigit(*cursor)) {
+            return fail(start, "expected an integer");
+        }
+        // Accumulate as a negative number so the most negative T still fits
+        const T lowest = std::numeric_limits<T>::min();
+        T result = 0;
+        while (cursor < end && isDigit(*cursor)) {
+            T digit = *cursor - '0';
+            if (result < (lowest + digit) / 10) {
+                return fail(start, "integer out of range");
+            }
+            result = result * 10 - digit;
+            ++cursor;
+        }
+        if (!negative) {
+            if (result == lowest) {
+                return fail(start, "integer out of range");
+            }
+            result = -result;
+        }
+        value = result;
+        return true;
+    }
+
+    /**
+    * Public : parseFraction
+    *
+    * Description:
+    *      Reads "a/b" or a bare integer "a" (which becomes a/1). Blanks are
+    *      allowed on either side of the slash.
+    *
+    * Params:
+    *      FractionToken<T>& frac : Receives the fraction and its text
+    *
+    * Returns:
+    *      bool : True on success
+    */
+    template <typename T>
+    bool parseFraction(FractionToken<T>& frac) {
+        skipBlanks();
+        const char* start = cursor;
+        if (!parseInteger(frac.numerator)) {
+            return false;
+        }
+        frac.denominator = 1;
+
+        const char* afterNumerator = cursor;
+        skipBlanks();
+        if (cursor < end && *cursor == '/') {
+            // Only a slash followed by a number belongs to this fraction.
+            // Anything else is the division operator and is left alone.
+            const char* slash = cursor;
+            ++cursor;
+            skipBlanks();
+            if (cursor < end && (isDigit(*cursor) ||
+                                 ((*cursor == '-' || *cursor == '+') && cursor + 1 < end &&
+                                  isDigit(cursor[1])))) {
+                if (!parseInteger(frac.denominator)) {
+                    return false;
+                }
+            } else if (slash + 1 < end && slash[1] != ' ' && slash[1] != '\t' && slash[1] != '(') {
+                return fail(slash + 1, "expected a denominator after '/'");
+            } else {
+                cursor = afterNumerator;
+            }
+        } else {
+            cursor = afterNumerator;
+        }
+        frac.text = std::string_view(start, (size_t)(cursor - start));
+        return true;
+    }
+
+    /**
+    * Public : parseOperator
+    *
+    * Description:
+    *      Reads a run of punctuation characters. The operator is not
+    *      validated here so the caller can decide how to report unknown
+    *      operators.
+    *
+    * Params:
+    *      std::string_view& op : Receives the operator text
+    *
+    * Returns:
+    *      bool : True if at least one operator character was read
+    */
+    bool parseOperator(std::string_view& op) {
+        skipBlanks();
+        const char* start = cursor;
+        while (cursor < end && isOperatorChar(*cursor)) {
+            ++cursor;
+        }
+        if (cursor == start) {
+            return fail(start, "expected an operator");
+        }
+        op = std::string_view(start, (size_t)(cursor - start));
+        return true;
+    }
+
+    /**
+    * Public : parseExpression
+    *
+    * Description:
+    *      Reads "fraction op fraction" and checks that nothing but blanks
+    *      follows it.
+    *
+    * Params:
+    *      ExpressionToken<T>& expr : Receives the parsed expression
+    *
+    * Returns:
+    *      bool : True on success
+    */
+    template <typename T>
+    bool parseExpression(ExpressionToken<T>& expr) {
+        if (!parseFraction(expr.left) || !parseOperator(expr.op) || !parseFraction(expr.right)) {
+            return false;
+        }
+        if (!atEnd()) {
+            return fail(cursor, "unexpected text after expression");
+        }
+        return true;
+    }
+
+    /**
+    * Public : atEnd
+    *
+    * Returns:
+    *      bool : True if only blanks are left in the buffer
+    */
+    bool atEnd() {
+        skipBlanks();
+        return cursor == end;
+    }
+
+    /**
+    * Public : peek
+    *
+    * Description:
+    *      Skips blanks and returns the next character without consuming it.
+    *
+    * Returns:
+    *      char : Next character, or '\0' at the end of the buffer
+    */
+    char peek() {
+        skipBlanks();
+        return cursor < end ? *cursor : '\0';
+    }
+
+    /**
+    * Public : advance
+    *
+    * Description:
+    *      Consumes count characters (used after peek()).
+    */
+    void advance(size_t count = 1) {
+        cursor = (size_t)(end - cursor) < count ? end : cursor + count;
+    }
+
+    /**
+    * Public : getPosition
+    *
+    * Returns:
+    *      const char* : The next unread character
+    */
+    const char* getPosition() const {
+        return cursor;
+    }
+
+    /**
+    * Public : setError
+    *
+    * Description:
+    *      Lets a caller building on this parser report its own errors with
+    *      the same line and column bookkeeping.
+    *
+    * Params:
+    *      const char* at      : Offending character
+    *      const char* message : String literal describing the problem
+    *
+    * Returns:
+    *      bool : Always false
+    */
+    bool setError(const char* at, const char* message) {
+        return fail(at, message);
+    }
+
+    /**
+    * Public : getError
+    *
+    * Returns:
+    *      const ParseError& : The error recorded by the last failed parse
+    */
+    const ParseError& getError() const {
+        return error;
+    }
+};
+
+#endif
@@ -0,0 +1,336 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            Fraction Records
+*  Title:            Packed Binary Job and Result Format
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This file defines a compact binary form of the "a/b op c/d" jobs
+*        the driver reads, and of the results it writes, so a job set can be
+*        converted once and then re-run without any text parsing.
+*
+*        Every file starts with a 16 byte header:
+*            bytes 0-3   magic "FRAC"
+*            bytes 4-7   format version (1), little-endian uint32
+*            bytes 8-11  record kind (0 = jobs, 1 = results), little-endian uint32
+*            bytes 12-15 reserved, zero
+*
+*        A job record is 33 bytes: an operator code (0 +, 1 -, 2 *, 3 /,
+*        4 ==) followed by n1, d1, n2 and d2 as little-endian int64.
+*
+*        A result record is 17 bytes: a status byte (the FractionStatus
+*        value, with bit 7 set if an input denominator was 0 and replaced by
+*        1, and bit 6 set if the job was "==") followed by the result's
+*        numerator and denominator as little-endian int64. For "==" the
+*        result is 1/1 when the fractions are equal and 0/1 when they are
+*        not. A job with an unknown operator code gets the status value
+*        0x3f and 0/1.
+*
+*        Input files are read through mmap() when possible, so the records
+*        are decoded straight out of the page cache.
+*
+*  Usage:
+*       - MappedFile jobs(STDIN_FILENO);
+*       - RecordHeader header; if (readHeader(jobs.data(), jobs.size(), header)) ...
+*       - ResultRecord r = evaluateRecord(decodeJob(p));
+*
+*  Files:
+*       fraction_record.hpp : header file with the record format
+*       fraction.hpp        : checked Fraction64 operations
+*****************************************************************************/
+
+#ifndef FRACTION_RECORD_HPP
+#define FRACTION_RECORD_HPP
+
+#include "fraction.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+const size_t recordHeaderSize = 16;         // Bytes in the file header
+const size_t jobRecordSize = 33;            // Operator code plus four int64 values
+const size_t resultRecordSize = 17;         // Status byte plus two int64 values
+const uint32_t recordVersion = 1;           // Version written into new files
+const uint8_t zeroDenominatorFlag = 0x80;   // Set in a result's status byte when an input denominator was 0
+const uint8_t comparisonFlag = 0x40;        // Set in a result's status byte when the job was "=="
+const uint8_t unknownOpStatus = 0x3f;       // Status value of a job whose operator code is unknown
+const uint8_t statusMask = 0x3f;            // Bits of the status byte that hold the status value
+
+/**
+ * RecordKind / RecordOp
+ *
+ * Description:
+ *      What a file holds, and the operator code of a job record.
+ */
+enum class RecordKind : uint32_t { Jobs = 0, Results = 1 };
+enum class RecordOp : uint8_t { Add = 0, Sub = 1, Mul = 2, Div = 3, Equal = 4 };
+
+/**
+ * JobRecord / ResultRecord
+ *
+ * Description:
+ *      Decoded forms of the two record types.
+ */
+struct JobRecord {
+    RecordOp op;
+    int64_t n1, d1, n2, d2;
+};
+
+struct ResultRecord {
+    uint8_t status;                 // FractionStatus or unknownOpStatus, plus zeroDenominatorFlag and comparisonFlag
+    int64_t numerator;
+    int64_t denominator;
+};
+
+struct RecordHeader {
+    uint32_t version;
+    RecordKind kind;
+};
+
+/**
+ * storeLE / loadLE
+ *
+ * Description:
+ *      Write or read an unsigned integer as little-endian bytes. Written
+ *      with shifts so the format is the same on every host; compilers turn
+ *      these into single moves on little-endian machines.
+ */
+template <typename U>
+inline void storeLE(char* p, U value) {
+    for (size_t i = 0; i < sizeof(U); ++i) {
+        p[i] = (char)(uint8_t)(value >> (8 * i));
+    }
+}
+
+template <typename U>
+inline U loadLE(const char* p) {
+    U value = 0;
+    for (size_t i = 0; i < sizeof(U); ++i) {
+        value |= (U)(uint8_t)p[i] << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * writeHeader / readHeader
+ *
+ * Description:
+ *      Build or check the 16 byte file header.
+ *
+ * Returns:
+ *      bool : readHeader returns false if the magic is wrong, the version is
+ *             unknown or the data is shorter than a header
+ */
+inline void writeHeader(char* p, RecordKind kind) {
+    std::memcpy(p, "FRAC", 4);
+    storeLE<uint32_t>(p + 4, recordVersion);
+    storeLE<uint32_t>(p + 8, (uint32_t)kind);
+    storeLE<uint32_t>(p + 12, 0);
+}
+
+inline bool readHeader(const char* p, size_t size, RecordHeader& header) {
+    if (size < recordHeaderSize || std::memcmp(p, "FRAC", 4) != 0) {
+        return false;
+    }
+    header.version = loadLE<uint32_t>(p + 4);
+    header.kind = (RecordKind)loadLE<uint32_t>(p + 8);
+    return header.version == recordVersion &&
+           (header.kind == RecordKind::Jobs || header.kind == RecordKind::Results);
+}
+
+/**
+ * encodeJob / decodeJob / encodeResult / decodeResult
+ *
+ * Description:
+ *      Convert between records and their packed bytes. p must have room
+ *      for jobRecordSize or resultRecordSize bytes.
+ */
+inline void encodeJob(char* p, const JobRecord& job) {
+    p[0] = (char)job.op;
+    storeLE<uint64_t>(p + 1, (uint64_t)job.n1);
+    storeLE<uint64_t>(p + 9, (uint64_t)job.d1);
+    storeLE<uint64_t>(p + 17, (uint64_t)job.n2);
+    storeLE<uint64_t>(p + 25, (uint64_t)job.d2);
+}
+
+inline JobRecord decodeJob(const char* p) {
+    JobRecord job;
+    job.op = (RecordOp)(uint8_t)p[0];
+    job.n1 = (int64_t)loadLE<uint64_t>(p + 1);
+    job.d1 = (int64_t)loadLE<uint64_t>(p + 9);
+    job.n2 = (int64_t)loadLE<uint64_t>(p + 17);
+    job.d2 = (int64_t)loadLE<uint64_t>(p + 25);
+    return job;
+}
+
+inline void encodeResult(char* p, const ResultRecord& result) {
+    p[0] = (char)result.status;
+    storeLE<uint64_t>(p + 1, (uint64_t)result.numerator);
+    storeLE<uint64_t>(p + 9, (uint64_t)result.denominator);
+}
+
+inline ResultRecord decodeResult(const char* p) {
+    ResultRecord result;
+    result.status = (uint8_t)p[0];
+    result.numerator = (int64_t)loadLE<uint64_t>(p + 1);
+    result.denominator = (int64_t)loadLE<uint64_t>(p + 9);
+    return result;
+}
+
+/**
+ * recordOpSymbol / recordOpFromText
+ *
+ * Description:
+ *      Map operator codes to and from the text the driver reads.
+ *
+ * Returns:
+ *      recordOpFromText returns false for an operator with no code
+ */
+inline const char* recordOpSymbol(RecordOp op) {
+    static const char* symbols[] = {"+", "-", "*", "/", "=="};
+    return (uint8_t)op <= 4 ? symbols[(uint8_t)op] : "?";
+}
+
+inline bool recordOpFromText(std::string_view text, RecordOp& op) {
+    static const char* symbols[] = {"+", "-", "*", "/", "=="};
+    for (uint8_t i = 0; i <= 4; ++i) {
+        if (text == symbols[i]) {
+            op = (RecordOp)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * evaluateRecord
+ *
+ * Description:
+ *      Runs one job with the checked Fraction64 operations, the same way
+ *      the text driver evaluates "a/b op c/d". An unknown operator code
+ *      gives unknownOpStatus with 0/1, so it is never mistaken for an
+ *      arithmetic error.
+ *
+ * Params:
+ *      const JobRecord& job : Job to run
+ *
+ * Returns:
+ *      ResultRecord : Status and reduced result
+ */
+inline ResultRecord evaluateRecord(const JobRecord& job) {
+    Fraction64 left, right, answer(0, 1);
+    uint8_t flags = 0;
+    if (Fraction64::create(job.n1, job.d1, left) == FractionStatus::ZeroDenominator) {
+        flags = zeroDenominatorFlag;
+    }
+    if (Fraction64::create(job.n2, job.d2, right) == FractionStatus::ZeroDenominator) {
+        flags = zeroDenominatorFlag;
+    }
+    FractionStatus status = FractionStatus::Ok;
+    switch (job.op) {
+        case RecordOp::Add:
+            status = left.checkedAdd(right, answer);
+            break;
+        case RecordOp::Sub:
+            status = left.checkedSub(right, answer);
+            break;
+        case RecordOp::Mul:
+            status = left.checkedMul(right, answer);
+            break;
+        case RecordOp::Div:
+            status = left.checkedDiv(right, answer);
+            break;
+        case RecordOp::Equal:
+            answer = Fraction64(left == right ? 1 : 0, 1);
+            flags |= comparisonFlag;
+            break;
+        default: {
+            ResultRecord unknown = {(uint8_t)(unknownOpStatus | flags), 0, 1};
+            return unknown;
+        }
+    }
+    ResultRecord result;
+    result.status = (uint8_t)((uint8_t)status | flags);
+    result.numerator = status == FractionStatus::Ok ? answer.getNumerator() : 0;
+    result.denominator = status == FractionStatus::Ok ? answer.getDenominator() : 1;
+    return result;
+}
+
+/**
+ * MappedFile
+ *
+ * Description:
+ *      Read-only view of a whole file. Regular files are mapped with
+ *      mmap(); anything that cannot be mapped (a pipe, for example) is read
+ *      into memory instead, so callers never have to care which happened.
+ *
+ * Public Methods:
+ *      MappedFile(int fd)              - Map or read all of fd
+ *      const char* data()
+ *      size_t size()
+ *      bool isMapped()                 - True if mmap() was used
+ *
+ * Usage:
+ *      MappedFile input(STDIN_FILENO);
+ *      for (size_t i = 16; i + 33 <= input.size(); i += 33) ...
+ */
+class MappedFile {
+    const char* base;               // Start of the file's bytes
+    size_t length;                  // Number of bytes
+    bool mapped;                    // True if base came from mmap()
+    std::vector<char> copy;         // Holds the bytes when mmap() could not be used
+
+public:
+    explicit MappedFile(int fd) : base(nullptr), length(0), mapped(false) {
+        struct stat info;
+        if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+            void* p = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                madvise(p, (size_t)info.st_size, MADV_SEQUENTIAL);
+                base = static_cast<const char*>(p);
+                length = (size_t)info.st_size;
+                mapped = true;
+                return;
+            }
+        }
+        char chunk[1 << 16];
+        ssize_t got;
+        while ((got = ::read(fd, chunk, sizeof(chunk))) > 0) {
+            copy.insert(copy.end(), chunk, chunk + got);
+        }
+        base = copy.data();
+        length = copy.size();
+    }
+
+    ~MappedFile() {
+        if (mapped) {
+            munmap(const_cast<char*>(base), length);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const {
+        return base;
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+    bool isMapped() const {
+        return mapped;
+    }
+};
+
+#endif
@@ -0,0 +1,446 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            FractionServer Class
+*  Title:            Unix Socket Server for Streaming Evaluation
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This class keeps the evaluator running as a long lived process that
+*        listens on a Unix domain socket, so small jobs do not pay for
+*        starting a new process every time. Up to maxClients clients are
+*        served at once; later ones wait in the listen queue until one
+*        leaves. Each one streams lines in the normal input format and gets
+*        back exactly what "./P01 < input" would print for those lines, in
+*        the same order.
+*
+*        Every client has a reader thread and a writer thread. The reader
+*        cuts whatever arrives into line-aligned blocks and submits them to
+*        one worker pool shared by all clients, so a client sending a burst
+*        of lines has them evaluated in parallel while the next block is
+*        still arriving. The writer sends the finished blocks back in order.
+*        A client may only have a few blocks in flight; once it hits that
+*        limit its reader stops reading until the writer catches up. A
+*        client that does not read its answers therefore ends up blocked in
+*        its own send() instead of growing the server's memory.
+*
+*  Usage:
+*       - FractionServer server(handler, threads);
+*       - if (server.listen("/tmp/p01.sock")) server.run();
+*       - stop() from a signal handler makes run() finish and clean up
+*       - a client that is still not reading its answers drainMillis after
+*         stop() is disconnected, so run() always returns
+*       - a client that sends more than maxLineBytes without a newline is
+*         disconnected once the lines before it have been answered
+*
+*  Files:
+*       fraction_server.hpp : header file containing the FractionServer class
+*       batch.hpp           : block evaluation shared with --batch
+*       thread_pool.hpp     : worker pool shared by every client
+*       output_buffer.hpp   : buffer each block's output is formatted into
+*****************************************************************************/
+
+#ifndef FRACTION_SERVER_HPP
+#define FRACTION_SERVER_HPP
+
+#include "batch.hpp"
+#include "output_buffer.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/**
+ * FractionServer
+ *
+ * Description:
+ *      Accepts clients on a Unix domain socket and evaluates their lines on
+ *      a shared ThreadPool with the same LineHandler the batch mode uses.
+ *
+ * Public Methods:
+ *      FractionServer(LineHandler h, size_t threads, size_t maxInFlight, size_t chunkSize)
+ *      ~FractionServer()                  - Stops and cleans up if still running
+ *      bool        listen(const std::string& path) - Creates the socket file
+ *      void        run()                  - Serves clients until stop()
+ *      void        stop()                 - Safe to call from a signal handler
+ *      std::string getError()             - Why listen() failed
+ *      uint64_t    getClientCount()       - Clients accepted so far
+ *      uint64_t    getLineCount()         - Lines answered so far
+ *
+ * Private Methods:
+ *      void readClient(Client& client)    - Socket to worker pool
+ *      void writeClient(Client& client)   - Worker pool to socket, in order
+ *      void reapClients(bool all)         - Joins clients that have finished
+ *
+ * Usage:
+ *      FractionServer server(evaluateLine<int64_t>, 4);
+ *      if (!server.listen("/tmp/p01.sock")) {
+ *          cerr << server.getError() << "\n";
+ *      } else {
+ *          server.run();
+ *      }
+ *
+ * Notes:
+ *      - A line is only evaluated once its newline arrives (or the client
+ *        shuts down its sending side), so a client should end every line
+ *        with '\n'. Answers come back as soon as their block is done.
+ *      - listen() replaces a stale socket file left behind by a previous
+ *        run, but never a regular file.
+ *      - If accept() fails for lack of descriptors or memory, run() records
+ *        the error (see getError()) and waits acceptBackoffMillis before
+ *        trying again instead of spinning on the still-readable socket.
+ *      - Every client costs two threads, so no more than maxClients are
+ *        accepted at once. While the server is full it stops polling the
+ *        listening socket and new connections wait in its backlog.
+ *      - The partial line held back for a client is capped at maxLineBytes,
+ *        so a client that never sends '\n' cannot grow the server's memory.
+ */
+class FractionServer {
+public:
+    typedef BatchEvaluator::LineHandler LineHandler;
+
+    static const int drainMillis = 2000;            // How long stopped clients get to take their last answers
+    static const int acceptBackoffMillis = 100;     // Pause after accept() fails for lack of resources
+    static const size_t maxClients = 64;            // Clients served at once (each has two threads)
+    static const size_t maxLineBytes = 1 << 20;     // Longest partial line a client may leave unfinished
+
+private:
+    typedef std::pair<OutputBuffer, size_t> BlockResult;
+
+    /**
+    * Client
+    *
+    * Description:
+    *      One connection. pending holds the blocks submitted to the pool
+    *      and not yet written, oldest first; lock guards it and the flags.
+    */
+    struct Client {
+        int fd;                                         // Connected socket
+        std::thread reader;                             // Runs readClient
+        std::thread writer;                             // Runs writeClient
+        std::mutex lock;
+        std::condition_variable changed;                // Signalled when pending or a flag changes
+        std::deque<std::future<BlockResult> > pending;  // Blocks in flight, in input order
+        bool readerDone;                                // No more blocks will be queued
+        bool failed;                                    // A write failed; stop reading
+        std::atomic<bool> finished;                     // Both threads are done, ready to join
+
+        explicit Client(int fd) : fd(fd), readerDone(false), failed(false), finished(false) {}
+    };
+
+    LineHandler handler;                // Evaluates one line
+    ThreadPool pool;                    // Workers shared by every client
+    size_t maxInFlight;                 // Blocks a client may have queued at once
+    size_t chunkSize;                   // Largest read from a client socket
+    int listenFd;                       // Listening socket, -1 when closed
+    std::string socketPath;             // Path passed to listen()
+    std::string error;                  // Why listen() or the last accept() failed
+    std::atomic<bool> stopping;         // Set by stop()
+    std::atomic<uint64_t> clientCount;  // Clients accepted
+    std::atomic<uint64_t> lineCount;    // Lines answered
+    std::list<std::unique_ptr<Client> > clients;    // Connections not yet joined
+
+    /**
+    * Private : readClient
+    *
+    * Description:
+    *      Reads from the client, holds back any partial last line, and
+    *      submits each line-aligned block to the pool. Blocks while the
+    *      client already has maxInFlight blocks queued. Stops reading once
+    *      the partial line grows past maxLineBytes; the blocks already
+    *      queued are still answered before the client is disconnected.
+    */
+    void readClient(Client& client) {
+        std::vector<char> carry;                        // Partial line left over from the last read
+        size_t nextLine = 1;                            // Line number of the next block's first line
+        bool done = false;
+        while (!done) {
+            std::vector<char> block;
+            block.swap(carry);
+            size_t have = block.size();
+            block.resize(have + chunkSize);
+            ssize_t got = ::read(client.fd, block.data() + have, chunkSize);
+            if (got < 0 && errno == EINTR) {
+                block.resize(have);
+                carry.swap(block);
+                continue;
+            }
+            block.resize(have + (got > 0 ? (size_t)got : 0));
+            if (got <= 0) {
+                done = true;                            // EOF, error or shutdown: evaluate what is left
+            } else {
+                size_t cut = block.size();
+                while (cut > have && block[cut - 1] != '\n') {
+                    --cut;
+                }
+                if (cut == have) {
+                    if (block.size() > maxLineBytes) {
+                        ::shutdown(client.fd, SHUT_RD); // Line too long: drop it and stop reading
+                        break;
+                    }
+                    carry.swap(block);                  // No complete line yet
+                    continue;
+                }
+                carry.assign(block.begin() + cut, block.end());
+                block.resize(cut);
+            }
+            if (block.empty()) {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> guard(client.lock);
+            client.changed.wait(guard, [&] { return client.pending.size() < maxInFlight || client.failed; });
+            if (client.failed) {
+                break;
+            }
+            size_t firstLine = nextLine;
+            nextLine += std::count(block.begin(), block.end(), '\n');
+            std::shared_ptr<std::vector<char> > shared = std::make_shared<std::vector<char> >(std::move(block));
+            client.pending.push_back(pool.submit([this, shared, firstLine] {
+                return BatchEvaluator::evaluateBlock(handler, shared->data(), shared->size(), firstLine);
+            }));
+            client.changed.notify_all();
+        }
+        std::lock_guard<std::mutex> guard(client.lock);
+        client.readerDone = true;
+        client.changed.notify_all();
+    }
+
+    /**
+    * Private : writeClient
+    *
+    * Description:
+    *      Waits for the oldest block, writes it, and repeats until the
+    *      reader is done and nothing is left. If the client goes away the
+    *      remaining blocks are still waited for (the workers are using
+    *      them) but not written. Shuts down the sending side at the end so
+    *      the client sees end of file; reapClients() closes the socket.
+    */
+    void writeClient(Client& client) {
+        while (true) {
+            std::unique_lock<std::mutex> guard(client.lock);
+            client.changed.wait(guard, [&] { return !client.pending.empty() || client.readerDone; });
+            if (client.pending.empty()) {
+                break;
+            }
+            std::future<BlockResult>& oldest = client.pending.front();  // deque references survive push_back
+            bool failed = client.failed;
+            guard.unlock();
+
+            BlockResult result = oldest.get();
+            if (!failed && result.first.writeTo(client.fd)) {
+                lineCount += result.second;
+            } else if (!failed) {
+                failed = true;
+                ::shutdown(client.fd, SHUT_RDWR);       // Wakes the reader if it is blocked in read()
+            }
+
+            guard.lock();
+            client.failed = client.failed || failed;    // run() may have given up on the client meanwhile
+            client.pending.pop_front();
+            client.changed.notify_all();
+        }
+        ::shutdown(client.fd, SHUT_WR);
+        client.finished = true;
+    }
+
+    /**
+    * Private : reapClients
+    *
+    * Description:
+    *      Joins and frees finished clients, or every client if all is set.
+    */
+    void reapClients(bool all) {
+        for (std::list<std::unique_ptr<Client> >::iterator it = clients.begin(); it != clients.end();) {
+            Client& client = **it;
+            if (all || client.finished) {
+                client.reader.join();
+                client.writer.join();
+                ::close(client.fd);
+                it = clients.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+public:
+    /**
+    * Constructor
+    *
+    * Params:
+    *      LineHandler h      : Function that evaluates a single line
+    *      size_t threads     : Worker threads shared by all clients (0 means one per core)
+    *      size_t maxInFlight : Blocks one client may have queued (defaults to 4)
+    *      size_t chunkSize   : Largest block read from a client (defaults to 256 KiB)
+    */
+    explicit FractionServer(LineHandler h, size_t threads = 0, size_t maxInFlight = 4, size_t chunkSize = 256 << 10)
+        : handler(std::move(h)),
+          pool(threads == 0 ? ThreadPool::defaultThreads() : threads),
+          maxInFlight(maxInFlight == 0 ? 1 : maxInFlight),
+          chunkSize(chunkSize == 0 ? 1 : chunkSize),
+          listenFd(-1),
+          stopping(false),
+          clientCount(0),
+          lineCount(0) {}
+
+    ~FractionServer() {
+        stop();
+        reapClients(true);
+        if (listenFd >= 0) {
+            ::close(listenFd);
+            ::unlink(socketPath.c_str());
+        }
+    }
+
+    FractionServer(const FractionServer&) = delete;
+    FractionServer& operator=(const FractionServer&) = delete;
+
+    /**
+    * Public : listen
+    *
+    * Description:
+    *      Creates and binds the socket file at path and starts listening.
+    *
+    * Params:
+    *      const std::string& path : Socket file to create
+    *
+    * Returns:
+    *      bool : False if the socket could not be set up (see getError())
+    */
+    bool listen(const std::string& path) {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+            error = "socket path is empty or too long";
+            return false;
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        struct stat info;
+        if (::lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+            ::unlink(path.c_str());                     // Left behind by a server that did not shut down cleanly
+        }
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || ::bind(fd, (sockaddr*)&address, sizeof(address)) != 0 || ::listen(fd, 128) != 0) {
+            error = path + ": " + std::strerror(errno);
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            return false;
+        }
+        listenFd = fd;
+        socketPath = path;
+        return true;
+    }
+
+    /**
+    * Public : run
+    *
+    * Description:
+    *      Accepts clients until stop() is called, at most maxClients at a
+    *      time, then lets every connected client finish the lines it has
+    *      already sent, closes the listening socket and removes the socket
+    *      file. Clients still busy after drainMillis are disconnected.
+    *      SIGPIPE is ignored so a client that disconnects early cannot kill
+    *      the server.
+    *
+    * Returns:
+    *      void
+    */
+    void run() {
+        std::signal(SIGPIPE, SIG_IGN);
+        while (!stopping && listenFd >= 0) {
+            bool full = clients.size() >= maxClients;   // New connections wait in the backlog until one leaves
+            pollfd waiting = {listenFd, (short)(full ? 0 : POLLIN), 0};
+            int ready = ::poll(&waiting, 1, full ? 50 : 200);   // Wake up now and then to notice stop() and reap clients
+            reapClients(false);
+            if (ready <= 0 || full) {
+                continue;
+            }
+            int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                    error = std::string("accept: ") + std::strerror(errno);
+                    ::poll(nullptr, 0, acceptBackoffMillis);    // The connection stays queued, so poll() would wake at once
+                }
+                continue;
+            }
+            ++clientCount;
+            clients.push_back(std::unique_ptr<Client>(new Client(fd)));
+            Client& client = *clients.back();
+            client.reader = std::thread([this, &client] { readClient(client); });
+            client.writer = std::thread([this, &client] { writeClient(client); });
+        }
+        if (listenFd >= 0) {
+            ::close(listenFd);
+            ::unlink(socketPath.c_str());
+            listenFd = -1;
+        }
+        for (std::unique_ptr<Client>& client : clients) {
+            if (!client->finished) {
+                ::shutdown(client->fd, SHUT_RD);        // No new input; answer what already arrived
+            }
+        }
+        for (int waited = 0; waited < drainMillis && !clients.empty(); waited += 50) {
+            reapClients(false);
+            if (!clients.empty()) {
+                ::poll(nullptr, 0, 50);
+            }
+        }
+        for (std::unique_ptr<Client>& client : clients) {
+            if (!client->finished) {
+                std::lock_guard<std::mutex> guard(client->lock);
+                client->failed = true;                  // Not reading its answers; drop the rest
+                ::shutdown(client->fd, SHUT_RDWR);      // Wakes the writer if it is blocked in send()
+                client->changed.notify_all();
+            }
+        }
+        reapClients(true);
+    }
+
+    /**
+    * Public : stop
+    *
+    * Description:
+    *      Asks run() to finish. Only stores an atomic flag, so it may be
+    *      called from a signal handler or another thread.
+    */
+    void stop() {
+        stopping = true;
+    }
+
+    std::string getError() const {
+        return error;
+    }
+
+    uint64_t getClientCount() const {
+        return clientCount;
+    }
+
+    uint64_t getLineCount() const {
+        return lineCount;
+    }
+};
+
+#endif
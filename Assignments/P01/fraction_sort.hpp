@@ -0,0 +1,131 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            Fraction Sorting
+*  Title:            Parallel Sort and Deduplication of Fractions
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This file sorts large vectors of fractions by value on a pool of
+*        worker threads and removes duplicates from sorted vectors. The
+*        vector is cut into one run per thread, each run is sorted on its
+*        own thread, and the runs are merged pairwise (also in parallel)
+*        until one sorted run is left. Sorting and merging are both stable,
+*        so fractions that are equal in value but written differently (1/2
+*        and 2/4) keep their input order and the result is the same for any
+*        thread count.
+*
+*  Usage:
+*       - parallelSort(values);                  // one thread per core
+*       - size_t distinct = uniqueSorted(values);
+*
+*  Files:
+*       fraction_sort.hpp : header file with the sort functions
+*       fraction.hpp      : BasicFraction and its overflow-safe ordering
+*       thread_pool.hpp   : worker pool the runs are sorted on
+*****************************************************************************/
+
+#ifndef FRACTION_SORT_HPP
+#define FRACTION_SORT_HPP
+
+#include "fraction.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <vector>
+
+/**
+ * parallelSort
+ *
+ * Description:
+ *      Stable sort of values by value, ascending. Small inputs (fewer than
+ *      minRun elements per thread) are sorted on the calling thread.
+ *
+ * Params:
+ *      std::vector<BasicFraction<T>>& values : Fractions to sort in place
+ *      size_t threads                       : Worker count (0 means one per core)
+ *      size_t minRun                        : Smallest run worth its own thread
+ *
+ * Returns:
+ *      void
+ */
+template <typename T>
+void parallelSort(std::vector<BasicFraction<T> >& values, size_t threads = 0, size_t minRun = 1 << 16) {
+    typedef typename std::vector<BasicFraction<T> >::iterator Iterator;
+    if (threads == 0) {
+        threads = ThreadPool::defaultThreads();
+    }
+    size_t count = values.size();
+    size_t runs = minRun == 0 ? threads : std::min(threads, count / minRun);
+    if (runs <= 1) {
+        std::stable_sort(values.begin(), values.end());
+        return;
+    }
+
+    ThreadPool pool(runs);
+    std::vector<size_t> bounds;                 // Run i is [bounds[i], bounds[i + 1])
+    for (size_t i = 0; i <= runs; ++i) {
+        bounds.push_back(count * i / runs);
+    }
+    std::vector<std::future<void> > pending;
+    for (size_t i = 0; i < runs; ++i) {
+        Iterator first = values.begin() + bounds[i];
+        Iterator last = values.begin() + bounds[i + 1];
+        pending.push_back(pool.submit([first, last] { std::stable_sort(first, last); }));
+    }
+    for (std::future<void>& done : pending) {
+        done.get();
+    }
+
+    // Merge neighbouring runs into the other buffer until one run is left
+    std::vector<BasicFraction<T> > buffer(count);
+    std::vector<BasicFraction<T> >* from = &values;
+    std::vector<BasicFraction<T> >* to = &buffer;
+    while (bounds.size() > 2) {
+        std::vector<size_t> merged;
+        pending.clear();
+        for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+            merged.push_back(bounds[i]);
+            size_t lo = bounds[i];
+            size_t mid = bounds[i + 1];
+            size_t hi = i + 2 < bounds.size() ? bounds[i + 2] : mid;
+            pending.push_back(pool.submit([from, to, lo, mid, hi] {
+                std::merge(from->begin() + lo, from->begin() + mid, from->begin() + mid,
+                           from->begin() + hi, to->begin() + lo);
+            }));
+        }
+        merged.push_back(count);
+        for (std::future<void>& done : pending) {
+            done.get();
+        }
+        bounds.swap(merged);
+        std::swap(from, to);
+    }
+    if (from != &values) {
+        values.swap(buffer);
+    }
+}
+
+/**
+ * uniqueSorted
+ *
+ * Description:
+ *      Removes fractions equal in value to the one before them from a
+ *      sorted vector, keeping the first of each group as written.
+ *
+ * Params:
+ *      std::vector<BasicFraction<T>>& values : Sorted fractions
+ *
+ * Returns:
+ *      size_t : Number of distinct values left
+ */
+template <typename T>
+size_t uniqueSorted(std::vector<BasicFraction<T> >& values) {
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    return values.size();
+}
+
+#endif
@@ -0,0 +1,316 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            Fraction Statistics
+*  Title:            Optional Operation Counters and Stage Timers
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This file is an instrumentation layer for finding out where a slow
+*        job spends its time. Compiled with -DFRACTION_STATS it counts every
+*        Fraction operation, GCD and LCM, keeps histograms of GCD loop
+*        iterations and operand bit widths, and times each stage of the
+*        driver (read, parse, compile, execute, format, write). The totals
+*        are written as JSON when the program exits, to the file named by
+*        the FRACTION_STATS_FILE environment variable or to stderr.
+*
+*        Without -DFRACTION_STATS every hook below expands to nothing, so
+*        the normal build runs exactly the same code as before.
+*
+*        Each thread counts into its own block, so the hooks never share a
+*        cache line between threads. A block is added to the totals when
+*        its thread exits.
+*
+*  Usage:
+*       - g++ -std=c++17 -O2 -pthread -DFRACTION_STATS -o P01 P01.cpp
+*       - FRACTION_STATS_FILE=stats.json ./P01 --batch < input > output
+*       - FRACTION_COUNT(StatOp::Add);               // in a hot path
+*       - FRACTION_STAGE(StatStage::Write);          // times the rest of the scope
+*
+*  Files:
+*       fraction_stats.hpp : header file with the counters and hooks
+*****************************************************************************/
+
+#ifndef FRACTION_STATS_HPP
+#define FRACTION_STATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * StatOp / StatStage
+ *
+ * Description:
+ *      What the counters and timers are kept for. Div is counted on its own
+ *      and again (with its operands) as the Mul it turns into.
+ */
+enum class StatOp { Add, Sub, Mul, Div, Compare, Gcd, Lcm, Count };
+enum class StatStage { Read, Parse, Compile, Execute, Format, Write, Count };
+
+#ifdef FRACTION_STATS
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+const size_t statOpCount = (size_t)StatOp::Count;
+const size_t statStageCount = (size_t)StatStage::Count;
+const size_t gcdBuckets = 16;           // Bucket i holds iteration counts below 2^i (and at least 2^(i-1))
+const size_t operandBitBuckets = 129;   // Bit widths 0 through 128
+
+/**
+ * StatsBlock
+ *
+ * Description:
+ *      One thread's counters. Plain integers: only the owning thread writes
+ *      them.
+ */
+struct StatsBlock {
+    uint64_t calls[statOpCount];
+    uint64_t gcdIterations[gcdBuckets];
+    uint64_t operandBits[operandBitBuckets];
+    uint64_t stageCalls[statStageCount];
+    uint64_t stageNanos[statStageCount];
+
+    StatsBlock() : calls(), gcdIterations(), operandBits(), stageCalls(), stageNanos() {}
+
+    void add(const StatsBlock& other) {
+        for (size_t i = 0; i < statOpCount; ++i) {
+            calls[i] += other.calls[i];
+        }
+        for (size_t i = 0; i < gcdBuckets; ++i) {
+            gcdIterations[i] += other.gcdIterations[i];
+        }
+        for (size_t i = 0; i < operandBitBuckets; ++i) {
+            operandBits[i] += other.operandBits[i];
+        }
+        for (size_t i = 0; i < statStageCount; ++i) {
+            stageCalls[i] += other.stageCalls[i];
+            stageNanos[i] += other.stageNanos[i];
+        }
+    }
+};
+
+/**
+ * FractionStats
+ *
+ * Description:
+ *      Process wide totals. Threads register their block when they first
+ *      count something and fold it in when they exit. The single instance
+ *      is created before any thread's block, so it is destroyed after all
+ *      of them (including the main thread's) and can write the JSON report
+ *      from its destructor.
+ *
+ * Public Methods:
+ *      static FractionStats& instance()
+ *      void       attach(const StatsBlock* block)  - A thread started counting
+ *      void       detach(const StatsBlock* block)  - A thread is exiting
+ *      StatsBlock total()                          - Current totals
+ *      void       writeJson(std::ostream& os)
+ *
+ * Usage:
+ *      FractionStats::instance().writeJson(std::cerr);
+ */
+class FractionStats {
+    std::mutex lock;                            // Guards finished and live
+    StatsBlock finished;                        // Totals of threads that exited
+    std::vector<const StatsBlock*> live;        // Blocks of running threads
+
+    FractionStats() {}
+
+public:
+    ~FractionStats() {
+        const char* path = std::getenv("FRACTION_STATS_FILE");
+        if (path != nullptr && *path != '\0') {
+            std::ofstream file(path);
+            writeJson(file);
+        } else {
+            writeJson(std::cerr);
+        }
+    }
+
+    static FractionStats& instance() {
+        static FractionStats stats;
+        return stats;
+    }
+
+    void attach(const StatsBlock* block) {
+        std::lock_guard<std::mutex> guard(lock);
+        live.push_back(block);
+    }
+
+    void detach(const StatsBlock* block) {
+        std::lock_guard<std::mutex> guard(lock);
+        finished.add(*block);
+        for (size_t i = 0; i < live.size(); ++i) {
+            if (live[i] == block) {
+                live.erase(live.begin() + i);
+                break;
+            }
+        }
+    }
+
+/**
+* Public : total
+*
+* Description:
+*      Adds up every thread's counters. Counts from threads that are still
+*      running may be a little behind.
+*/
+    StatsBlock total() {
+        std::lock_guard<std::mutex> guard(lock);
+        StatsBlock sum = finished;
+        for (const StatsBlock* block : live) {
+            sum.add(*block);
+        }
+        return sum;
+    }
+
+/**
+* Public : writeJson
+*
+* Description:
+*      Writes the totals as one JSON object:
+*          "operations"     : calls per operation
+*          "gcd_iterations" : [{"below": 2^i, "count": n}, ...] (empty buckets left out)
+*          "operand_bits"   : {"bits": count, ...} for each operand of + - * / compare
+*          "stages"         : {"read": {"calls": n, "ms": t}, ...}
+*/
+    void writeJson(std::ostream& os) {
+        static const char* opNames[] = {"add", "sub", "mul", "div", "compare", "gcd", "lcm"};
+        static const char* stageNames[] = {"read", "parse", "compile", "execute", "format", "write"};
+        StatsBlock sum = total();
+        os << "{\n  \"operations\": {";
+        for (size_t i = 0; i < statOpCount; ++i) {
+            os << (i ? ", " : "") << "\"" << opNames[i] << "\": " << sum.calls[i];
+        }
+        os << "},\n  \"gcd_iterations\": [";
+        bool first = true;
+        for (size_t i = 0; i < gcdBuckets; ++i) {
+            if (sum.gcdIterations[i] != 0) {
+                os << (first ? "" : ", ") << "{\"below\": " << (1ULL << i) << ", \"count\": " << sum.gcdIterations[i]
+                   << "}";
+                first = false;
+            }
+        }
+        os << "],\n  \"operand_bits\": {";
+        first = true;
+        for (size_t i = 0; i < operandBitBuckets; ++i) {
+            if (sum.operandBits[i] != 0) {
+                os << (first ? "" : ", ") << "\"" << i << "\": " << sum.operandBits[i];
+                first = false;
+            }
+        }
+        os << "},\n  \"stages\": {";
+        for (size_t i = 0; i < statStageCount; ++i) {
+            os << (i ? ", " : "") << "\"" << stageNames[i] << "\": {\"calls\": " << sum.stageCalls[i]
+               << ", \"ms\": " << sum.stageNanos[i] / 1000000.0 << "}";
+        }
+        os << "}\n}\n";
+    }
+};
+
+/**
+ * ThreadStats
+ *
+ * Description:
+ *      Owns a thread's StatsBlock and registers it for the thread's
+ *      lifetime.
+ */
+struct ThreadStats {
+    StatsBlock block;
+
+    ThreadStats() {
+        FractionStats::instance().attach(&block);
+    }
+
+    ~ThreadStats() {
+        FractionStats::instance().detach(&block);
+    }
+};
+
+inline StatsBlock& threadStats() {
+    static thread_local ThreadStats stats;
+    return stats.block;
+}
+
+/**
+ * countOp / recordGcd / recordOperand
+ *
+ * Description:
+ *      The hooks behind the macros. recordGcd also counts the call, and
+ *      recordOperand takes |numerator| | |denominator|, whose bit width is
+ *      the wider of the two.
+ */
+inline void countOp(StatOp op) {
+    ++threadStats().calls[(size_t)op];
+}
+
+inline void recordGcd(unsigned iterations) {
+    size_t bucket = 0;
+    while (bucket + 1 < gcdBuckets && (iterations >> bucket) != 0) {
+        ++bucket;
+    }
+    StatsBlock& stats = threadStats();
+    ++stats.calls[(size_t)StatOp::Gcd];
+    ++stats.gcdIterations[bucket];
+}
+
+template <typename U>
+inline void recordOperand(U bits) {
+    size_t width = 0;
+    while (bits != 0) {
+        bits >>= 1;
+        ++width;
+    }
+    ++threadStats().operandBits[width];
+}
+
+/**
+ * StageTimer
+ *
+ * Description:
+ *      Adds the time from construction to destruction to a stage.
+ */
+class StageTimer {
+    StatStage stage;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit StageTimer(StatStage stage) : stage(stage), start(std::chrono::steady_clock::now()) {}
+
+    ~StageTimer() {
+        StatsBlock& stats = threadStats();
+        ++stats.stageCalls[(size_t)stage];
+        stats.stageNanos[(size_t)stage] += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                               std::chrono::steady_clock::now() - start)
+                                               .count();
+    }
+};
+
+// The counting hooks run inside constexpr functions, so they are skipped
+// while the compiler evaluates a constant (a _frac literal, for example).
+#define FRACTION_STATS_ONLY(...) __VA_ARGS__
+#define FRACTION_COUNT(op) (__builtin_is_constant_evaluated() ? (void)0 : countOp(op))
+#define FRACTION_GCD_ITERATIONS(n) (__builtin_is_constant_evaluated() ? (void)0 : recordGcd(n))
+#define FRACTION_OPERAND(bits) (__builtin_is_constant_evaluated() ? (void)0 : recordOperand(bits))
+#define FRACTION_STAGE_JOIN(a, b) a##b
+#define FRACTION_STAGE_NAME(line) FRACTION_STAGE_JOIN(stageTimer, line)
+#define FRACTION_STAGE(stage) StageTimer FRACTION_STAGE_NAME(__LINE__)(stage)
+
+#else
+
+#define FRACTION_STATS_ONLY(...)
+#define FRACTION_COUNT(op) ((void)0)
+#define FRACTION_GCD_ITERATIONS(n) ((void)0)
+#define FRACTION_OPERAND(bits) ((void)0)
+#define FRACTION_STAGE(stage) ((void)0)
+
+#endif
+
+#endif
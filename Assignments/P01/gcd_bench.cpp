@@ -0,0 +1,177 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            GCD Benchmark
+*  Title:            GCD Backend Micro-Benchmark
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This program times every GCD backend in int_math.hpp (plus std::gcd
+*        as a reference point) on several operand distributions, and times
+*        the old multiply-first lcm against the divide-first one. Each
+*        backend runs over the same pre-generated operand pairs, and the
+*        program exits non-zero if the GCD backends ever disagree.
+*
+*  Usage:
+*       - $ ./gcd_bench [pairs] [rounds]
+*       - pairs defaults to 1000000, rounds to 5 (the best round is reported)
+*
+*  Files:
+*       gcd_bench.cpp : benchmark driver
+*       int_math.hpp  : GCD and LCM kernels being measured
+*****************************************************************************/
+
+#include "int_math.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+typedef pair<uint64_t, uint64_t> Operands;
+
+/**
+ * makeOperands
+ *
+ * Description:
+ *      Builds count operand pairs from the named distribution. A fixed seed
+ *      keeps every run comparable.
+ *
+ * Params:
+ *      const string& kind : "small", "coprime", "pow2" or "random64"
+ *      size_t count       : Number of pairs to build
+ *
+ * Returns:
+ *      vector<Operands> : The operand pairs
+ */
+vector<Operands> makeOperands(const string& kind, size_t count) {
+    mt19937_64 rng(2143);
+    vector<Operands> ops(count);
+    for (size_t i = 0; i < count; i++) {
+        uint64_t a, b;
+        if (kind == "small") {                          // typical hand-written fractions
+            a = rng() % 1000 + 1;
+            b = rng() % 1000 + 1;
+        } else if (kind == "coprime") {                 // random 32 bit pairs with no common factor
+            do {
+                a = (rng() >> 32) + 1;
+                b = (rng() >> 32) + 1;
+            } while (std::gcd(a, b) != 1);
+        } else if (kind == "pow2") {                    // best case for the binary backend
+            a = 1ULL << (rng() % 63);
+            b = 1ULL << (rng() % 63);
+        } else {                                        // full width random values
+            a = rng() | 1;
+            b = rng() | 2;
+        }
+        ops[i] = Operands(a, b);
+    }
+    return ops;
+}
+
+/**
+ * keepAlive
+ *
+ * Description:
+ *      Tells the compiler the value is used, so timed loops are not hoisted
+ *      or thrown away.
+ */
+inline void keepAlive(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(value) : "memory");
+#else
+    volatile uint64_t sink = value;
+    (void)sink;
+#endif
+}
+
+/**
+ * timeKernel
+ *
+ * Description:
+ *      Runs kernel over every pair rounds times and returns the best time
+ *      per call in nanoseconds. The results are summed into checksum so the
+ *      compiler cannot drop the calls.
+ *
+ * Params:
+ *      const vector<Operands>& ops : Operand pairs
+ *      int rounds                  : Times to repeat the run
+ *      Kernel kernel               : Function under test
+ *      uint64_t& checksum          : Receives the sum of all results
+ *
+ * Returns:
+ *      double : Best nanoseconds per call
+ */
+template <typename Kernel>
+double timeKernel(const vector<Operands>& ops, int rounds, Kernel kernel, uint64_t& checksum) {
+    double best = 1e300;
+    for (int r = 0; r < rounds; r++) {
+        uint64_t sum = 0;
+        auto start = chrono::steady_clock::now();
+        for (const Operands& op : ops) {
+            sum += kernel(op.first, op.second);
+        }
+        keepAlive(sum);
+        auto stop = chrono::steady_clock::now();
+        double ns = chrono::duration<double, nano>(stop - start).count() / ops.size();
+        if (ns < best) {
+            best = ns;
+        }
+        checksum = sum;
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    size_t pairs = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 5;
+    if (pairs == 0 || rounds <= 0) {
+        cerr << "Usage: " << argv[0] << " [pairs] [rounds]\n";
+        return 1;
+    }
+
+    const char* kinds[] = {"small", "coprime", "pow2", "random64"};
+    cout << "pairs=" << pairs << " rounds=" << rounds << " (ns per call, best round)\n";
+    cout << left << setw(10) << "operands" << right << setw(10) << "euclid" << setw(10) << "binary"
+         << setw(10) << "std::gcd" << setw(12) << "lcm(a*b)/g" << setw(12) << "lcm a/g*b" << "\n";
+
+    bool ok = true;
+    for (const char* kind : kinds) {
+        vector<Operands> ops = makeOperands(kind, pairs);
+        uint64_t sumEuclid, sumBinary, sumStd, sumOldLcm, sumNewLcm;
+
+        double euclid = timeKernel(ops, rounds, [](uint64_t a, uint64_t b) {
+            return gcd<GcdBackend::Euclid>(a, b);
+        }, sumEuclid);
+        double binary = timeKernel(ops, rounds, [](uint64_t a, uint64_t b) {
+            return gcd<GcdBackend::Binary>(a, b);
+        }, sumBinary);
+        double reference = timeKernel(ops, rounds, [](uint64_t a, uint64_t b) {
+            return std::gcd(a, b);
+        }, sumStd);
+        // The old Fraction::lcm: multiply first, then divide (wraps on large operands)
+        double oldLcm = timeKernel(ops, rounds, [](uint64_t a, uint64_t b) {
+            return (a * b) / gcd<GcdBackend::Euclid>(a, b);
+        }, sumOldLcm);
+        double newLcm = timeKernel(ops, rounds, [](uint64_t a, uint64_t b) {
+            return fastLcm(a, b);
+        }, sumNewLcm);
+
+        if (sumEuclid != sumBinary || sumEuclid != sumStd || sumOldLcm == 0 || sumNewLcm == 0) {
+            cerr << kind << ": GCD backends disagree\n";
+            ok = false;
+        }
+        cout << fixed << setprecision(2) << left << setw(10) << kind << right << setw(10) << euclid
+             << setw(10) << binary << setw(10) << reference << setw(12) << oldLcm << setw(12)
+             << newLcm << "\n";
+    }
+    return ok ? 0 : 1;
+}
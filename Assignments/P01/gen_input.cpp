@@ -0,0 +1,146 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            Input Generator
+*  Title:            Synthetic Workload Generator for P01
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This program writes large input files in the format the P01 driver
+*        reads, so the batch mode and the benchmarks can be run on millions
+*        of lines instead of the five in "input". The same seed always
+*        produces the same file.
+*
+*        Workloads:
+*          small    : "a/b op c/d" with values up to 1000
+*          large    : "a/b op c/d" with full 32 bit values
+*          repeat   : small lines drawn from a pool of 1000, so most repeat
+*          expr     : longer expressions with parentheses and unary minus
+*          mixed    : a blend of the above, with a few malformed lines
+*
+*  Usage:
+*       - $ ./gen_input [lines] [workload] [seed] > big_input
+*       - lines defaults to 1000000, workload to small, seed to 2143
+*
+*  Files:
+*       gen_input.cpp : workload generator
+*****************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const char* operators[] = {"+", "-", "*", "/", "=="};
+
+/**
+ * Generator
+ *
+ * Description:
+ *      Holds the random engine and writes one line of a workload at a time.
+ *
+ * Public Methods:
+ *      Generator(uint64_t seed)
+ *      string fraction(uint64_t limit)     - "a/b", sometimes negative
+ *      string simple(uint64_t limit)       - "a/b op c/d"
+ *      string expression(int depth)        - Nested expression
+ *      string malformed()                  - A line the parser rejects
+ *
+ * Usage:
+ *      Generator gen(2143);
+ *      cout << gen.simple(1000) << "\n";
+ */
+class Generator {
+    mt19937_64 rng;             // Seeded engine, the only source of randomness
+
+public:
+    explicit Generator(uint64_t seed) : rng(seed) {}
+
+    uint64_t below(uint64_t limit) {
+        return rng() % limit;
+    }
+
+    string fraction(uint64_t limit) {
+        string text;
+        if (below(8) == 0) {
+            text += "-";
+        }
+        text += to_string(below(limit) + 1);
+        text += "/";
+        text += to_string(below(limit) + 1);
+        return text;
+    }
+
+    string simple(uint64_t limit) {
+        return fraction(limit) + " " + operators[below(5)] + " " + fraction(limit);
+    }
+
+    string expression(int depth) {
+        if (depth == 0 || below(3) == 0) {
+            return fraction(100);
+        }
+        string left = expression(depth - 1);
+        string right = expression(depth - 1);
+        string op = operators[below(4)];
+        string text = below(2) == 0 ? "(" + left + " " + op + " " + right + ")" : left + " " + op + " " + right;
+        return below(10) == 0 ? "-" + text : text;
+    }
+
+    string malformed() {
+        const char* bad[] = {"1/2 ^ 3/4", "1/x + 2", "1/2 +", "(1/2 + 3/4", "1/2 3/4"};
+        return bad[below(5)];
+    }
+};
+
+int main(int argc, char* argv[]) {
+    size_t lines = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    string workload = argc > 2 ? argv[2] : "small";
+    uint64_t seed = argc > 3 ? strtoull(argv[3], nullptr, 10) : 2143;
+    if (workload != "small" && workload != "large" && workload != "repeat" && workload != "expr" &&
+        workload != "mixed") {
+        cerr << "Usage: " << argv[0] << " [lines] [small|large|repeat|expr|mixed] [seed]\n";
+        return 1;
+    }
+
+    Generator gen(seed);
+    vector<string> pool;                    // pool holds the lines the repeat workload draws from
+    if (workload == "repeat" || workload == "mixed") {
+        for (int i = 0; i < 1000; i++) {
+            pool.push_back(gen.simple(1000));
+        }
+    }
+
+    string out;                             // out collects lines and is flushed in big writes
+    for (size_t i = 0; i < lines; i++) {
+        string kind = workload;
+        if (kind == "mixed") {
+            const char* kinds[] = {"small", "small", "large", "repeat", "repeat", "expr", "bad"};
+            kind = kinds[gen.below(7)];
+        }
+        if (kind == "small") {
+            out += gen.simple(1000);
+        } else if (kind == "large") {
+            out += gen.simple(4294967295ULL);
+        } else if (kind == "repeat") {
+            out += pool[gen.below(pool.size())];
+        } else if (kind == "expr") {
+            out += gen.expression(3);
+        } else {
+            out += gen.malformed();
+        }
+        out += '\n';
+        if (out.size() > (1 << 20)) {
+            fwrite(out.data(), 1, out.size(), stdout);
+            out.clear();
+        }
+    }
+    fwrite(out.data(), 1, out.size(), stdout);
+    return 0;
+}
@@ -0,0 +1,373 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            Integer Math
+*  Title:            GCD and LCM Kernels
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This file holds the integer kernels the Fraction class is built on.
+*        There are two GCD backends: the classic Euclid loop, which does one
+*        integer division per step, and Stein's binary GCD, which only uses
+*        shifts, subtractions and count-trailing-zeros. Binary is the default
+*        because integer division is by far the slowest instruction in the
+*        fraction code. Build with -DFRACTION_GCD_EUCLID to switch back.
+*
+*        lcm divides by the GCD before it multiplies, so it only overflows
+*        when the answer itself does not fit. Every kernel is constexpr so
+*        constant fractions can be reduced at compile time.
+*
+*        The checked helpers at the bottom wrap the compiler's overflow
+*        builtins so every integer width (including __int128) can report
+*        overflow instead of silently wrapping.
+*
+*  Usage:
+*       - fastGcd(a, b)                       : GCD using the selected backend
+*       - gcd<GcdBackend::Euclid>(a, b)       : GCD using a specific backend
+*       - fastLcm(a, b)                       : LCM without the a * b overflow
+*       - addOverflow(a, b, out)              : out = a + b, true on overflow
+*
+*  Files:
+*       int_math.hpp       : header file containing the integer kernels
+*       fraction_stats.hpp : optional GCD and LCM counters (-DFRACTION_STATS)
+*****************************************************************************/
+
+#ifndef INT_MATH_HPP
+#define INT_MATH_HPP
+
+#include "fraction_stats.hpp"
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/**
+ * GcdBackend
+ *
+ * Description:
+ *      Which algorithm gcd() uses.
+ */
+enum class GcdBackend { Euclid, Binary };
+
+#ifdef FRACTION_GCD_EUCLID
+constexpr GcdBackend defaultGcdBackend = GcdBackend::Euclid;
+#else
+constexpr GcdBackend defaultGcdBackend = GcdBackend::Binary;
+#endif
+
+/**
+ * UnsignedOf
+ *
+ * Description:
+ *      Unsigned type of the same width as T. std::make_unsigned does not
+ *      know about __int128 in strict mode, so it is handled here.
+ */
+template <typename T>
+struct UnsignedOf {
+    typedef typename std::make_unsigned<T>::type type;
+};
+
+#ifdef __SIZEOF_INT128__
+template <>
+struct UnsignedOf<__int128> {
+    typedef unsigned __int128 type;
+};
+template <>
+struct UnsignedOf<unsigned __int128> {
+    typedef unsigned __int128 type;
+};
+#endif
+
+/**
+ * WideOf
+ *
+ * Description:
+ *      Integer type twice as wide as T, used where products of two T values
+ *      must not overflow. __int128 has nothing wider and maps to itself.
+ */
+template <typename T>
+struct WideOf {
+    typedef int64_t type;
+};
+
+#ifdef __SIZEOF_INT128__
+template <>
+struct WideOf<int64_t> {
+    typedef __int128 type;
+};
+template <>
+struct WideOf<__int128> {
+    typedef __int128 type;
+};
+#endif
+
+/**
+ * countTrailingZeros
+ *
+ * Description:
+ *      Number of zero bits below the lowest set bit. x must not be zero.
+ *      Uses the compiler intrinsic for each width when one is available.
+ *
+ * Params:
+ *      U x : Non-zero unsigned value
+ *
+ * Returns:
+ *      int : Trailing zero count
+ */
+template <typename U>
+constexpr int countTrailingZeros(U x) {
+#if defined(__GNUC__) || defined(__clang__)
+    if constexpr (sizeof(U) <= sizeof(unsigned int)) {
+        return __builtin_ctz((unsigned int)x);
+    } else if constexpr (sizeof(U) <= sizeof(unsigned long long)) {
+        return __builtin_ctzll((unsigned long long)x);
+    } else {
+        unsigned long long low = (unsigned long long)x;
+        if (low != 0) {
+            return __builtin_ctzll(low);
+        }
+        return 64 + __builtin_ctzll((unsigned long long)(x >> 64));
+    }
+#else
+    int n = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/**
+ * magnitude
+ *
+ * Description:
+ *      Absolute value as an unsigned number, so the most negative value of
+ *      a signed type does not overflow.
+ */
+template <typename T>
+constexpr typename UnsignedOf<T>::type magnitude(T x) {
+    typedef typename UnsignedOf<T>::type U;
+    return x < 0 ? (U)(U(0) - (U)x) : (U)x;
+}
+
+/**
+ * euclidGcd
+ *
+ * Description:
+ *      Modulo based Euclid loop. One division per iteration.
+ *
+ * Params:
+ *      U a : First value
+ *      U b : Second value
+ *
+ * Returns:
+ *      U : gcd(a, b), with gcd(0, 0) == 0
+ */
+template <typename U>
+constexpr U euclidGcd(U a, U b) {
+    FRACTION_STATS_ONLY(unsigned iterations = 0;)
+    while (b != 0) {
+        U temp = b;
+        b = a % b;
+        a = temp;
+        FRACTION_STATS_ONLY(++iterations;)
+    }
+    FRACTION_GCD_ITERATIONS(iterations);
+    return a;
+}
+
+/**
+ * binaryGcd
+ *
+ * Description:
+ *      Stein's binary GCD. The common power of two is pulled out once with
+ *      count-trailing-zeros, then the loop only shifts and subtracts.
+ *
+ * Params:
+ *      U a : First value
+ *      U b : Second value
+ *
+ * Returns:
+ *      U : gcd(a, b), with gcd(0, 0) == 0
+ */
+template <typename U>
+constexpr U binaryGcd(U a, U b) {
+    if (a == 0 || b == 0) {
+        FRACTION_GCD_ITERATIONS(0);
+        return a | b;
+    }
+    FRACTION_STATS_ONLY(unsigned iterations = 0;)
+    int shift = countTrailingZeros(a | b);
+    a >>= countTrailingZeros(a);
+    do {
+        FRACTION_STATS_ONLY(++iterations;)
+        b >>= countTrailingZeros(b);
+        // Branch free "a = min(a, b); b = |b - a|" so the loop never mispredicts
+        U mask = U(0) - U(b < a);
+        U diff = b - a;
+        a += diff & mask;
+        b = (diff + mask) ^ mask;
+    } while (b != 0);
+    FRACTION_GCD_ITERATIONS(iterations);
+    return a << shift;
+}
+
+/**
+ * gcd
+ *
+ * Description:
+ *      GCD of two signed or unsigned values using the chosen backend. The
+ *      result is always non-negative.
+ *
+ * Params:
+ *      T a : First value
+ *      T b : Second value
+ *
+ * Returns:
+ *      T : gcd(|a|, |b|)
+ */
+template <GcdBackend B, typename T>
+constexpr T gcd(T a, T b) {
+    typedef typename UnsignedOf<T>::type U;
+    U ua = magnitude(a);
+    U ub = magnitude(b);
+    if constexpr (B == GcdBackend::Binary) {
+        return (T)binaryGcd(ua, ub);
+    } else {
+        return (T)euclidGcd(ua, ub);
+    }
+}
+
+/**
+ * fastGcd
+ *
+ * Description:
+ *      GCD using the backend picked at build time.
+ */
+template <typename T>
+constexpr T fastGcd(T a, T b) {
+    return gcd<defaultGcdBackend>(a, b);
+}
+
+/**
+ * fastLcm
+ *
+ * Description:
+ *      LCM that divides by the GCD before multiplying, so a * b is never
+ *      formed. The result is always non-negative.
+ *
+ * Params:
+ *      T a : First value
+ *      T b : Second value
+ *
+ * Returns:
+ *      T : lcm(|a|, |b|), or 0 if either value is 0
+ */
+template <typename T>
+constexpr T fastLcm(T a, T b) {
+    FRACTION_COUNT(StatOp::Lcm);
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    typedef typename UnsignedOf<T>::type U;
+    U ua = magnitude(a);
+    U ub = magnitude(b);
+    U g = (U)fastGcd(ua, ub);
+    return (T)((ua / g) * ub);
+}
+
+/**
+ * addOverflow / subOverflow / mulOverflow
+ *
+ * Description:
+ *      Store the wrapped result of a + b, a - b or a * b in out and return
+ *      true if the exact result did not fit in T. They never invoke
+ *      undefined behaviour, so the wrapped value is still well defined.
+ *
+ * Params:
+ *      T a    : Left operand
+ *      T b    : Right operand
+ *      T& out : Receives the (possibly wrapped) result
+ *
+ * Returns:
+ *      bool : True if the operation overflowed
+ */
+template <typename T>
+constexpr bool addOverflow(T a, T b, T& out) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_add_overflow(a, b, &out);
+#else
+    typedef typename UnsignedOf<T>::type U;
+    out = (T)((U)a + (U)b);
+    return (b > 0 && a > std::numeric_limits<T>::max() - b) ||
+           (b < 0 && a < std::numeric_limits<T>::min() - b);
+#endif
+}
+
+template <typename T>
+constexpr bool subOverflow(T a, T b, T& out) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_sub_overflow(a, b, &out);
+#else
+    typedef typename UnsignedOf<T>::type U;
+    out = (T)((U)a - (U)b);
+    return (b < 0 && a > std::numeric_limits<T>::max() + b) ||
+           (b > 0 && a < std::numeric_limits<T>::min() + b);
+#endif
+}
+
+template <typename T>
+constexpr bool mulOverflow(T a, T b, T& out) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_mul_overflow(a, b, &out);
+#else
+    typedef typename UnsignedOf<T>::type U;
+    out = (T)((U)a * (U)b);
+    if (a == 0 || b == 0) {
+        return false;
+    }
+    return out / b != a || (a == -1 && b == std::numeric_limits<T>::min()) ||
+           (b == -1 && a == std::numeric_limits<T>::min());
+#endif
+}
+
+/**
+ * compareRatios
+ *
+ * Description:
+ *      Compares p/q with r/s for unsigned values (q and s not zero) without
+ *      multiplying, so it works at any width. The integer parts are compared
+ *      first; if they match, the fractional parts are compared by flipping
+ *      them over, which walks the continued fraction expansions of both
+ *      values and stops at the first difference, like Euclid's algorithm.
+ *
+ * Returns:
+ *      int : -1, 0 or 1 as p/q is less than, equal to or greater than r/s
+ */
+template <typename U>
+constexpr int compareRatios(U p, U q, U r, U s) {
+    int flip = 1;
+    while (true) {
+        U wholeLeft = p / q;
+        U wholeRight = r / s;
+        if (wholeLeft != wholeRight) {
+            return wholeLeft < wholeRight ? -flip : flip;
+        }
+        p %= q;
+        r %= s;
+        if (p == 0 || r == 0) {
+            return p == r ? 0 : (p == 0 ? -flip : flip);
+        }
+        U t = p;                                    // p/q < r/s exactly when q/p > s/r
+        p = q;
+        q = t;
+        t = r;
+        r = s;
+        s = t;
+        flip = -flip;
+    }
+}
+
+#endif
@@ -0,0 +1,182 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            OutputBuffer Class
+*  Title:            Buffered Result Writer
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This class collects the driver's output in one large reusable
+*        buffer. Integers and fractions are formatted with std::to_chars
+*        straight into the buffer (no locale, no stream state), and the
+*        whole buffer goes out with a single write() call, so a block of
+*        thousands of results costs one system call instead of one or two
+*        per line.
+*
+*  Usage:
+*       - OutputBuffer out;
+*       - out << "1/2 + 1/4\n" << Fraction64(3, 4) << '\n';
+*       - out.writeTo(1);                          // one write() to stdout
+*
+*  Files:
+*       output_buffer.hpp : header file containing the OutputBuffer class
+*       fraction.hpp      : BasicFraction, printed by operator<<
+*****************************************************************************/
+
+#ifndef OUTPUT_BUFFER_HPP
+#define OUTPUT_BUFFER_HPP
+
+#include "fraction.hpp"
+#include "fraction_stats.hpp"
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unistd.h>
+
+/**
+ * OutputBuffer
+ *
+ * Description:
+ *      Growable character buffer with fast integer and fraction formatting.
+ *      Writing it out empties it but keeps its capacity for the next block.
+ *
+ * Public Methods:
+ *                           OutputBuffer(size_t capacity)
+ *      OutputBuffer&        operator<<(std::string_view text)
+ *      OutputBuffer&        operator<<(char ch)
+ *      OutputBuffer&        operator<<(Integer value)           - Any built-in integer but char
+ *      OutputBuffer&        operator<<(const BasicFraction<T>& frac)
+ *      OutputBuffer&        appendInteger(T value)
+ *      bool                 writeTo(int fd)          - write() everything, then clear
+ *      size_t               size()
+ *      void                 clear()
+ *
+ * Usage:
+ *      OutputBuffer out(1 << 20);
+ *      for (...) out << line << '\n' << result << '\n';
+ *      out.writeTo(STDOUT_FILENO);
+ */
+class OutputBuffer {
+    std::string buffer;                 // Pending output
+
+public:
+    explicit OutputBuffer(size_t capacity = 1 << 16) {
+        buffer.reserve(capacity);
+    }
+
+    OutputBuffer& operator<<(std::string_view text) {
+        buffer.append(text.data(), text.size());
+        return *this;
+    }
+
+    OutputBuffer& operator<<(char ch) {
+        buffer.push_back(ch);
+        return *this;
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, char>::value, OutputBuffer&>::type
+    operator<<(T value) {
+        return appendInteger(value);
+    }
+
+    /**
+    * Public : appendInteger
+    *
+    * Description:
+    *      Formats value with std::to_chars directly into the buffer.
+    *      __int128 has no to_chars overload, so its digits are produced by
+    *      hand the same way writeInteger() does.
+    *
+    * Params:
+    *      T value : Integer to append
+    *
+    * Returns:
+    *      OutputBuffer& : This buffer, for chaining
+    */
+    template <typename T>
+    OutputBuffer& appendInteger(T value) {
+        char digits[48];
+        char* end = digits + sizeof(digits);
+        char* start = digits;
+        if constexpr (sizeof(T) <= sizeof(long long)) {
+            end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        } else {
+            start = end;
+            typename UnsignedOf<T>::type mag = magnitude(value);
+            do {
+                *--start = (char)('0' + (int)(mag % 10));
+                mag /= 10;
+            } while (mag != 0);
+            if (value < 0) {
+                *--start = '-';
+            }
+        }
+        buffer.append(start, end - start);
+        return *this;
+    }
+
+    /**
+    * Public : operator<<
+    *
+    * Description:
+    *      Appends a fraction as numerator/denominator, matching the stream
+    *      operator in fraction.hpp.
+    */
+    template <typename T>
+    OutputBuffer& operator<<(const BasicFraction<T>& frac) {
+        appendInteger(frac.getNumerator());
+        buffer.push_back('/');
+        return appendInteger(frac.getDenominator());
+    }
+
+    /**
+    * Public : writeTo
+    *
+    * Description:
+    *      Writes the whole buffer to a file descriptor, normally in one
+    *      write() call (it loops on short writes and EINTR), then empties
+    *      the buffer.
+    *
+    * Params:
+    *      int fd : File descriptor to write to
+    *
+    * Returns:
+    *      bool : False if a write failed; the buffer is emptied either way
+    */
+    bool writeTo(int fd) {
+        FRACTION_STAGE(StatStage::Write);
+        const char* p = buffer.data();
+        size_t left = buffer.size();
+        bool ok = true;
+        while (left > 0) {
+            ssize_t wrote = ::write(fd, p, left);
+            if (wrote < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ok = false;
+                break;
+            }
+            p += wrote;
+            left -= (size_t)wrote;
+        }
+        buffer.clear();
+        return ok;
+    }
+
+    size_t size() const {
+        return buffer.size();
+    }
+
+    void clear() {
+        buffer.clear();
+    }
+};
+
+#endif
@@ -0,0 +1,246 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            ParallelReducer Class
+*  Title:            Parallel Tree Reduction of Fractions
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This class sums or multiplies very large collections of fractions on
+*        a pool of worker threads. The input is cut into fixed size blocks,
+*        each block is folded with a FractionAccumulator, and the block
+*        results are combined pairwise in a balanced tree. Folding one long
+*        chain grows the denominator one step at a time; the tree keeps both
+*        sides of every step about the same size instead.
+*
+*        The blocks and the tree only depend on the input and the block
+*        size, never on the number of threads, so the result (including
+*        whether it overflows) is the same for any thread count.
+*
+*  Usage:
+*       - ParallelReducer<int64_t> reducer(8);    // eight worker threads
+*       - ReductionResult<int64_t> total = reducer.sum(values);
+*       - total.status, total.value, total.threadMillis
+*
+*  Files:
+*       parallel_reduce.hpp      : header file containing the ParallelReducer class
+*       fraction_accumulator.hpp : lazily reduced fold used inside each block
+*       thread_pool.hpp          : worker pool the blocks run on
+*****************************************************************************/
+
+#ifndef PARALLEL_REDUCE_HPP
+#define PARALLEL_REDUCE_HPP
+
+#include "fraction.hpp"
+#include "fraction_accumulator.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * ReductionResult
+ *
+ * Description:
+ *      Value of a parallel sum or product and where the time went.
+ */
+template <typename T>
+struct ReductionResult {
+    FractionStatus status;              // First error in tree order, or Ok
+    BasicFraction<T> value;             // Reduced result when status is Ok
+    std::vector<double> threadMillis;   // Time each pool thread spent folding blocks, busiest first
+    double combineMillis;               // Time spent combining block results
+};
+
+/**
+ * ParallelReducer
+ *
+ * Description:
+ *      Owns a ThreadPool and reduces arrays of BasicFraction<T> with it.
+ *      The blocks are split into one job per pool thread, each a
+ *      contiguous run of blocks. The pool decides which thread runs which
+ *      job, so every job reports the id of the thread that ran it and the
+ *      times are added up per thread. threadMillis has one entry per pool
+ *      thread; a thread that ran no job (or a second job) shows up as 0
+ *      (or as the sum of both).
+ *
+ * Public Methods:
+ *                           ParallelReducer(size_t threads, size_t blockSize)
+ *      ReductionResult<T>   sum(const std::vector<BasicFraction<T>>& values)
+ *      ReductionResult<T>   product(const std::vector<BasicFraction<T>>& values)
+ *      size_t               getThreadCount()
+ *
+ * Private Methods:
+ *      ReductionResult<T>   reduce(const BasicFraction<T>* data, size_t count, bool product)
+ *      Partial              foldBlock(const BasicFraction<T>* data, size_t count, bool product)
+ *      Partial              combine(const Partial& left, const Partial& right, bool product)
+ *
+ * Usage:
+ *      vector<Fraction64> values = ...;
+ *      ParallelReducer<int64_t> reducer;         // one thread per core
+ *      ReductionResult<int64_t> sum = reducer.sum(values);
+ *      if (sum.status == FractionStatus::Ok)
+ *          cout << sum.value;
+ */
+template <typename T>
+class ParallelReducer {
+    typedef std::pair<FractionStatus, BasicFraction<T> > Partial;
+
+    ThreadPool pool;                    // Workers that fold the blocks
+    size_t blockSize;                   // Fractions per leaf of the tree
+
+    /**
+    * Private : foldBlock
+    *
+    * Description:
+    *      Folds one block left to right, reducing only when needed.
+    */
+    static Partial foldBlock(const BasicFraction<T>* data, size_t count, bool product) {
+        FractionAccumulator<T> acc(BasicFraction<T>(product ? 1 : 0, 1));
+        for (size_t i = 0; i < count; ++i) {
+            if (product) {
+                acc *= data[i];
+            } else {
+                acc += data[i];
+            }
+        }
+        Partial result(FractionStatus::Ok, BasicFraction<T>(0, 1));
+        result.first = acc.result(result.second);
+        return result;
+    }
+
+    /**
+    * Private : combine
+    *
+    * Description:
+    *      Joins two neighbouring partial results. An error on the left wins
+    *      over one on the right, so the reported error is deterministic too.
+    */
+    static Partial combine(const Partial& left, const Partial& right, bool product) {
+        if (left.first != FractionStatus::Ok) {
+            return left;
+        }
+        if (right.first != FractionStatus::Ok) {
+            return right;
+        }
+        Partial result(FractionStatus::Ok, BasicFraction<T>(0, 1));
+        if (product) {
+            result.first = left.second.checkedMul(right.second, result.second);
+        } else {
+            result.first = left.second.checkedAdd(right.second, result.second);
+        }
+        return result;
+    }
+
+    /**
+    * Private : reduce
+    *
+    * Description:
+    *      Folds the blocks on the pool, then combines them level by level:
+    *      block 2i with 2i+1, then those results pairwise, and so on. An odd
+    *      block at the end of a level moves up unchanged.
+    */
+    ReductionResult<T> reduce(const BasicFraction<T>* data, size_t count, bool product) {
+        typedef std::chrono::steady_clock Clock;
+        ReductionResult<T> result;
+        result.status = FractionStatus::Ok;
+        result.value = BasicFraction<T>(product ? 1 : 0, 1);
+        result.combineMillis = 0;
+
+        size_t blocks = (count + blockSize - 1) / blockSize;
+        std::vector<Partial> partials(blocks, Partial(FractionStatus::Ok, result.value));
+        size_t workers = pool.size() < blocks ? pool.size() : blocks;
+        typedef std::pair<std::thread::id, double> JobTime;
+        std::vector<std::future<JobTime> > pending;
+        for (size_t w = 0; w < workers; ++w) {
+            size_t first = blocks * w / workers;
+            size_t last = blocks * (w + 1) / workers;
+            pending.push_back(pool.submit([this, data, count, product, first, last, &partials] {
+                Clock::time_point start = Clock::now();
+                for (size_t b = first; b < last; ++b) {
+                    size_t begin = b * blockSize;
+                    size_t size = count - begin < blockSize ? count - begin : blockSize;
+                    partials[b] = foldBlock(data + begin, size, product);
+                }
+                return JobTime(std::this_thread::get_id(),
+                               std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+            }));
+        }
+        std::vector<std::thread::id> threads;           // threads[i] is the thread threadMillis[i] belongs to
+        for (std::future<JobTime>& done : pending) {
+            JobTime job = done.get();
+            size_t i = std::find(threads.begin(), threads.end(), job.first) - threads.begin();
+            if (i == threads.size()) {
+                threads.push_back(job.first);
+                result.threadMillis.push_back(0);
+            }
+            result.threadMillis[i] += job.second;
+        }
+        result.threadMillis.resize(pool.size(), 0);    // Threads that ran no job
+        std::sort(result.threadMillis.begin(), result.threadMillis.end(), std::greater<double>());
+
+        Clock::time_point start = Clock::now();
+        while (partials.size() > 1) {
+            size_t half = (partials.size() + 1) / 2;
+            for (size_t i = 0; i < half; ++i) {
+                if (2 * i + 1 < partials.size()) {
+                    partials[i] = combine(partials[2 * i], partials[2 * i + 1], product);
+                } else {
+                    partials[i] = partials[2 * i];
+                }
+            }
+            partials.resize(half);
+        }
+        result.combineMillis = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        if (!partials.empty()) {
+            result.status = partials[0].first;
+            result.value = partials[0].second;
+        }
+        return result;
+    }
+
+public:
+    /**
+    * Constructor
+    *
+    * Params:
+    *      size_t threads   : Worker thread count (0 means one per core)
+    *      size_t blockSize : Fractions folded per block before the tree starts
+    */
+    explicit ParallelReducer(size_t threads = 0, size_t blockSize = 4096)
+        : pool(threads == 0 ? ThreadPool::defaultThreads() : threads),
+          blockSize(blockSize == 0 ? 1 : blockSize) {}
+
+/**
+* Public : sum / product
+*
+* Description:
+*      Reduce every value with + or *. An empty input gives 0/1 or 1/1.
+*
+* Params:
+*      const std::vector<BasicFraction<T>>& values : Fractions to reduce
+*
+* Returns:
+*      ReductionResult<T> : Status, value and per-thread timings
+*/
+    ReductionResult<T> sum(const std::vector<BasicFraction<T> >& values) {
+        return reduce(values.data(), values.size(), false);
+    }
+
+    ReductionResult<T> product(const std::vector<BasicFraction<T> >& values) {
+        return reduce(values.data(), values.size(), true);
+    }
+
+    size_t getThreadCount() const {
+        return pool.size();
+    }
+};
+
+#endif
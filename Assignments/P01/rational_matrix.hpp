@@ -0,0 +1,500 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            RationalMatrix Class
+*  Title:            Exact Linear Algebra with Bareiss Elimination
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This class holds a matrix of fractions and computes its exact
+*        determinant, inverse and the solution of A x = b. Instead of
+*        Gaussian elimination with Fraction operators (a GCD on every element
+*        update, and entries that keep growing), each row is first scaled by
+*        the LCM of its denominators so the matrix is all integers, and then
+*        fraction-free Bareiss elimination runs on those integers. Every
+*        update is a*d - b*c followed by an exact division by the previous
+*        pivot, so no GCD is needed and the entries never grow past the size
+*        of a minor of the matrix. Fractions only come back at the very end.
+*
+*        The integer work matrix stores each row contiguously with its
+*        length rounded up to a whole number of cache lines, so one pivot
+*        step streams through memory row by row, and rows can be handed out
+*        to worker threads without two threads touching the same line.
+*
+*  Usage:
+*       - RationalMatrix<int64_t> a(2, 2);
+*       - a(0, 0) = Fraction64(1, 2); ...
+*       - Fraction64 det; a.determinant(det);
+*       - vector<Fraction64> x; a.solve(b, x);
+*
+*  Files:
+*       rational_matrix.hpp : header file containing the RationalMatrix class
+*       fraction.hpp        : BasicFraction used for inputs and outputs
+*       fraction_array.hpp  : AlignedAllocator for the work matrix
+*       thread_pool.hpp     : workers for the optional parallel row updates
+*****************************************************************************/
+
+#ifndef RATIONAL_MATRIX_HPP
+#define RATIONAL_MATRIX_HPP
+
+#include "fraction.hpp"
+#include "fraction_array.hpp"
+#include "int_math.hpp"
+#include "thread_pool.hpp"
+#include <cstddef>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+/**
+ * RationalMatrix
+ *
+ * Description:
+ *      Dense rows x cols matrix of BasicFraction<T>. The elimination runs
+ *      in WideOf<T> with every multiply and subtract checked, so a result
+ *      that does not fit reports Overflow instead of a wrong answer.
+ *
+ * Public Methods:
+ *                           RationalMatrix(size_t rows, size_t cols)   - All 0/1
+ *      static RationalMatrix identity(size_t n)
+ *      size_t               rows() / cols()
+ *      BasicFraction<T>&    operator()(size_t r, size_t c)
+ *      FractionStatus       determinant(BasicFraction<T>& det, size_t threads)
+ *      FractionStatus       solve(const std::vector<BasicFraction<T>>& b, std::vector<BasicFraction<T>>& x, size_t threads)
+ *      FractionStatus       inverse(RationalMatrix& result, size_t threads)
+ *      friend std::ostream& operator<<(std::ostream& os, const RationalMatrix& m)
+ *
+ * Private Methods:
+ *      FractionStatus       load(Workspace& work, const std::vector<BasicFraction<T>>& rhs, size_t extra, std::vector<W>& scales)
+ *      FractionStatus       eliminate(Workspace& work, bool jordan, W& pivot, size_t threads)
+ *      FractionStatus       updateRows(Workspace& work, size_t k, size_t first, size_t last, bool jordan, W previous)
+ *      static FractionStatus toFraction(W num, W den, BasicFraction<T>& out)
+ *
+ * Usage:
+ *      RationalMatrix<int64_t> a(3, 3);
+ *      ...fill a(r, c)...
+ *      RationalMatrix<int64_t> inv(3, 3);
+ *      if (a.inverse(inv) == FractionStatus::Ok)
+ *          cout << inv;
+ *
+ * Notes:
+ *      - determinant, solve and inverse need a square matrix.
+ *      - A singular matrix makes solve and inverse return DivideByZero
+ *        (the determinant is then 0/1).
+ *      - threads > 1 splits every pivot step's row updates across a pool;
+ *        it only pays off for matrices with a few hundred rows or more.
+ */
+template <typename T>
+class RationalMatrix {
+    typedef typename WideOf<T>::type W;
+
+    /**
+    * Workspace
+    *
+    * Description:
+    *      Integer matrix with rows padded to whole cache lines.
+    */
+    struct Workspace {
+        size_t rows;
+        size_t cols;
+        size_t stride;                                  // Elements per stored row
+        std::vector<W, AlignedAllocator<W, 64> > cells;
+
+        Workspace(size_t rows, size_t cols)
+            : rows(rows), cols(cols),
+              stride((cols * sizeof(W) + 63) / 64 * 64 / sizeof(W)),
+              cells(rows * stride, W(0)) {}
+
+        W* row(size_t r) {
+            return cells.data() + r * stride;
+        }
+    };
+
+    size_t rowCount;                                    // Number of rows
+    size_t colCount;                                    // Number of columns
+    std::vector<BasicFraction<T> > cells;               // Row-major entries
+
+    /**
+    * Private : load
+    *
+    * Description:
+    *      Copies the matrix into work, multiplying row i by the LCM of its
+    *      denominators so every entry is an integer. The extra columns
+    *      after the matrix are taken from rhs (extra entries per row) and
+    *      scaled with the same multiplier.
+    *
+    * Params:
+    *      Workspace& work                    : Receives the integer rows
+    *      const std::vector<BasicFraction<T>>& rhs : Right hand side, row-major
+    *      size_t extra                       : Right hand side columns
+    *      std::vector<W>& scales             : Receives each row's multiplier
+    *
+    * Returns:
+    *      FractionStatus : Overflow if a scaled entry does not fit in W
+    */
+    FractionStatus load(Workspace& work, const std::vector<BasicFraction<T> >& rhs, size_t extra,
+                        std::vector<W>& scales) const {
+        scales.assign(rowCount, W(1));
+        for (size_t r = 0; r < rowCount; ++r) {
+            W scale = 1;
+            for (size_t c = 0; c < colCount + extra; ++c) {
+                const BasicFraction<T>& f = c < colCount ? cells[r * colCount + c] : rhs[r * extra + (c - colCount)];
+                W den = f.getDenominator();
+                W g = fastGcd(scale, den);
+                if (mulOverflow(scale, den / g, scale)) {
+                    return FractionStatus::Overflow;
+                }
+            }
+            W* row = work.row(r);
+            for (size_t c = 0; c < colCount + extra; ++c) {
+                const BasicFraction<T>& f = c < colCount ? cells[r * colCount + c] : rhs[r * extra + (c - colCount)];
+                W num = f.getNumerator();
+                W den = f.getDenominator();
+                if (mulOverflow(num, scale / den, row[c])) {
+                    return FractionStatus::Overflow;
+                }
+            }
+            scales[r] = scale;
+        }
+        return FractionStatus::Ok;
+    }
+
+    /**
+    * Private : updateRows
+    *
+    * Description:
+    *      The Bareiss update for pivot k on rows [first, last):
+    *          a[i][j] = (a[k][k] * a[i][j] - a[i][k] * a[k][j]) / previous
+    *      The division is always exact. Without jordan only rows below k
+    *      and columns right of k change; with jordan every row except k is
+    *      updated, and the earlier pivots on the diagonal become a[k][k].
+    */
+    static FractionStatus updateRows(Workspace& work, size_t k, size_t first, size_t last, bool jordan, W previous) {
+        const W* pivotRow = work.row(k);
+        W pivot = pivotRow[k];
+        for (size_t i = first; i < last; ++i) {
+            if (i == k) {
+                continue;
+            }
+            W* row = work.row(i);
+            W factor = row[k];
+            for (size_t j = k + 1; j < work.cols; ++j) {
+                W left = 0, right = 0, diff = 0;
+                if (mulOverflow(pivot, row[j], left) || mulOverflow(factor, pivotRow[j], right) ||
+                    subOverflow(left, right, diff)) {
+                    return FractionStatus::Overflow;
+                }
+                row[j] = diff / previous;
+            }
+            row[k] = 0;
+            if (jordan && i < k) {
+                row[i] = pivot;
+            }
+        }
+        return FractionStatus::Ok;
+    }
+
+    /**
+    * Private : eliminate
+    *
+    * Description:
+    *      Runs Bareiss elimination over the first rowCount columns of work,
+    *      swapping in a lower row whenever a pivot is zero. With jordan the
+    *      rows above each pivot are cleared as well, which leaves pivot * I
+    *      on the left and pivot * A^-1 * (right hand side) on the right.
+    *
+    * Params:
+    *      Workspace& work : Integer matrix, updated in place
+    *      bool jordan     : Clear above the pivots too
+    *      W& pivot        : Receives the last pivot, the determinant of the
+    *                        scaled matrix (0 if singular)
+    *      size_t threads  : Threads for the row updates (1 means none)
+    *
+    * Returns:
+    *      FractionStatus : Overflow if an intermediate value did not fit
+    */
+    FractionStatus eliminate(Workspace& work, bool jordan, W& pivot, size_t threads) const {
+        size_t n = rowCount;
+        W previous = 1;
+        bool negate = false;
+        std::unique_ptr<ThreadPool> pool;
+        if (threads > 1 && n > threads) {
+            pool.reset(new ThreadPool(threads));
+        }
+        pivot = 0;
+        for (size_t k = 0; k < n; ++k) {
+            size_t swap = k;
+            while (swap < n && work.row(swap)[k] == 0) {
+                ++swap;
+            }
+            if (swap == n) {
+                pivot = 0;
+                return FractionStatus::Ok;                  // singular
+            }
+            if (swap != k) {
+                W* a = work.row(k);
+                W* b = work.row(swap);
+                for (size_t j = 0; j < work.cols; ++j) {
+                    W t = a[j];
+                    a[j] = b[j];
+                    b[j] = t;
+                }
+                negate = !negate;
+            }
+
+            size_t first = jordan ? 0 : k + 1;
+            if (!pool) {
+                if (updateRows(work, k, first, n, jordan, previous) != FractionStatus::Ok) {
+                    return FractionStatus::Overflow;
+                }
+            } else {
+                std::vector<std::future<FractionStatus> > pending;
+                size_t count = n - first;
+                for (size_t t = 0; t < threads; ++t) {
+                    size_t lo = first + count * t / threads;
+                    size_t hi = first + count * (t + 1) / threads;
+                    if (lo < hi) {
+                        pending.push_back(pool->submit([&work, k, lo, hi, jordan, previous] {
+                            return updateRows(work, k, lo, hi, jordan, previous);
+                        }));
+                    }
+                }
+                bool overflow = false;
+                for (std::future<FractionStatus>& done : pending) {
+                    overflow |= done.get() != FractionStatus::Ok;
+                }
+                if (overflow) {
+                    return FractionStatus::Overflow;
+                }
+            }
+            previous = work.row(k)[k];
+        }
+        pivot = negate ? -previous : previous;
+        return FractionStatus::Ok;
+    }
+
+    /**
+    * Private : toFraction
+    *
+    * Description:
+    *      Reduces num/den in W and stores it in out if it fits in T.
+    */
+    static FractionStatus toFraction(W num, W den, BasicFraction<T>& out) {
+        W g = fastGcd(num, den);
+        if (g > 1) {
+            num /= g;
+            den /= g;
+        }
+        if (den < 0 && (subOverflow(W(0), num, num) || subOverflow(W(0), den, den))) {
+            return FractionStatus::Overflow;
+        }
+        if ((W)(T)num != num || (W)(T)den != den) {
+            return FractionStatus::Overflow;
+        }
+        out = BasicFraction<T>((T)num, (T)den);
+        return FractionStatus::Ok;
+    }
+
+public:
+    RationalMatrix(size_t rows, size_t cols)
+        : rowCount(rows), colCount(cols), cells(rows * cols, BasicFraction<T>(0, 1)) {}
+
+    static RationalMatrix identity(size_t n) {
+        RationalMatrix m(n, n);
+        for (size_t i = 0; i < n; ++i) {
+            m(i, i) = BasicFraction<T>(1, 1);
+        }
+        return m;
+    }
+
+    size_t rows() const {
+        return rowCount;
+    }
+
+    size_t cols() const {
+        return colCount;
+    }
+
+    BasicFraction<T>& operator()(size_t r, size_t c) {
+        return cells[r * colCount + c];
+    }
+
+    const BasicFraction<T>& operator()(size_t r, size_t c) const {
+        return cells[r * colCount + c];
+    }
+
+/**
+* Public : determinant
+*
+* Description:
+*      Exact determinant: the last Bareiss pivot of the scaled matrix,
+*      divided by the product of the row scales.
+*
+* Params:
+*      BasicFraction<T>& det : Receives the determinant
+*      size_t threads        : Threads for the row updates (default 1)
+*
+* Returns:
+*      FractionStatus : Ok, or Overflow (also for a non-square matrix)
+*/
+    FractionStatus determinant(BasicFraction<T>& det, size_t threads = 1) const {
+        if (rowCount != colCount) {
+            return FractionStatus::Overflow;
+        }
+        if (rowCount == 0) {
+            det = BasicFraction<T>(1, 1);                   // the empty product
+            return FractionStatus::Ok;
+        }
+        Workspace work(rowCount, colCount);
+        std::vector<W> scales;
+        W pivot = 0;
+        std::vector<BasicFraction<T> > none;
+        FractionStatus status = load(work, none, 0, scales);
+        if (status == FractionStatus::Ok) {
+            status = eliminate(work, false, pivot, threads);
+        }
+        if (status != FractionStatus::Ok) {
+            return status;
+        }
+        if (pivot == 0) {
+            det = BasicFraction<T>(0, 1);
+            return FractionStatus::Ok;
+        }
+        // det(A) = pivot / product of scales; divide scale by scale to keep the numbers small
+        W num = pivot;
+        W den = 1;
+        for (W scale : scales) {
+            W g = fastGcd(num, scale);
+            num /= g;
+            if (mulOverflow(den, scale / g, den)) {
+                return FractionStatus::Overflow;
+            }
+        }
+        return toFraction(num, den, det);
+    }
+
+/**
+* Public : solve
+*
+* Description:
+*      Solves A x = b exactly with fraction-free Gauss-Jordan elimination
+*      on [A | b]. Each x[i] is then one division: right side / pivot.
+*
+* Params:
+*      const std::vector<BasicFraction<T>>& b : Right hand side, rows() entries
+*      std::vector<BasicFraction<T>>& x       : Receives the solution
+*      size_t threads                         : Threads for the row updates
+*
+* Returns:
+*      FractionStatus : Ok, Overflow, or DivideByZero if A is singular
+*/
+    FractionStatus solve(const std::vector<BasicFraction<T> >& b, std::vector<BasicFraction<T> >& x,
+                         size_t threads = 1) const {
+        if (rowCount != colCount || b.size() != rowCount) {
+            return FractionStatus::Overflow;
+        }
+        if (rowCount == 0) {
+            x.clear();
+            return FractionStatus::Ok;
+        }
+        Workspace work(rowCount, colCount + 1);
+        std::vector<W> scales;
+        W pivot = 0;
+        FractionStatus status = load(work, b, 1, scales);
+        if (status == FractionStatus::Ok) {
+            status = eliminate(work, true, pivot, threads);
+        }
+        if (status != FractionStatus::Ok) {
+            return status;
+        }
+        if (pivot == 0) {
+            return FractionStatus::DivideByZero;
+        }
+        W diagonal = work.row(rowCount - 1)[rowCount - 1];  // every diagonal entry equals the last pivot
+        x.assign(rowCount, BasicFraction<T>(0, 1));
+        for (size_t i = 0; i < rowCount; ++i) {
+            status = toFraction(work.row(i)[colCount], diagonal, x[i]);
+            if (status != FractionStatus::Ok) {
+                return status;
+            }
+        }
+        return FractionStatus::Ok;
+    }
+
+/**
+* Public : inverse
+*
+* Description:
+*      Exact inverse by Gauss-Jordan elimination on [A' | S], where A' is
+*      A with row i scaled by s[i] and S = diag(s). The right half ends up
+*      as pivot * A^-1.
+*
+* Params:
+*      RationalMatrix& result : Receives the inverse
+*      size_t threads         : Threads for the row updates
+*
+* Returns:
+*      FractionStatus : Ok, Overflow, or DivideByZero if A is singular
+*/
+    FractionStatus inverse(RationalMatrix& result, size_t threads = 1) const {
+        if (rowCount != colCount) {
+            return FractionStatus::Overflow;
+        }
+        size_t n = rowCount;
+        if (n == 0) {
+            result = RationalMatrix(0, 0);
+            return FractionStatus::Ok;
+        }
+        Workspace work(n, 2 * n);
+        std::vector<W> scales;
+        std::vector<BasicFraction<T> > none(n * n, BasicFraction<T>(0, 1));
+        FractionStatus status = load(work, none, n, scales);
+        if (status != FractionStatus::Ok) {
+            return status;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            work.row(i)[n + i] = scales[i];
+        }
+        W pivot = 0;
+        status = eliminate(work, true, pivot, threads);
+        if (status != FractionStatus::Ok) {
+            return status;
+        }
+        if (pivot == 0) {
+            return FractionStatus::DivideByZero;
+        }
+        W diagonal = work.row(n - 1)[n - 1];
+        result = RationalMatrix(n, n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                status = toFraction(work.row(i)[n + j], diagonal, result(i, j));
+                if (status != FractionStatus::Ok) {
+                    return status;
+                }
+            }
+        }
+        return FractionStatus::Ok;
+    }
+
+/**
+* Public : operator<< (Friend Function)
+*
+* Description:
+*      Prints the matrix one row per line with the entries separated by
+*      spaces.
+*/
+    friend std::ostream& operator<<(std::ostream& os, const RationalMatrix& m) {
+        for (size_t r = 0; r < m.rowCount; ++r) {
+            for (size_t c = 0; c < m.colCount; ++c) {
+                os << (c ? " " : "") << m(r, c);
+            }
+            os << "\n";
+        }
+        return os;
+    }
+};
+
+#endif
@@ -0,0 +1,168 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            ResultCache Class
+*  Title:            Bounded CLOCK Result Cache
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This class remembers the results of recent expressions so a file
+*        full of repeated lines only does the math once per distinct line.
+*        It holds at most as many entries as fit in a memory limit and picks
+*        victims with the CLOCK algorithm: every entry has a "referenced" bit
+*        set on each hit, and a hand sweeps the entries, clearing set bits
+*        and evicting the first entry whose bit is already clear. That gives
+*        close to LRU hit rates without moving anything on a hit.
+*
+*  Usage:
+*       - ResultCache<int> cache(1 << 20);       // about 1 MiB
+*       - if (const int* hit = cache.find(key)) ... else cache.insert(key, value);
+*       - cache.getCounters().hits
+*
+*  Files:
+*       result_cache.hpp : header file containing the ResultCache class
+*****************************************************************************/
+
+#ifndef RESULT_CACHE_HPP
+#define RESULT_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * CacheCounters
+ *
+ * Description:
+ *      Running totals for one cache.
+ */
+struct CacheCounters {
+    uint64_t hits;                  // Lookups that found an entry
+    uint64_t misses;                // Lookups that did not
+    uint64_t evictions;             // Entries replaced to make room
+};
+
+/**
+ * ResultCache
+ *
+ * Description:
+ *      Map from a byte string key to a value of type V with a fixed number
+ *      of slots. The slot array is reserved up front and never reallocates,
+ *      so the index can hold string_views into the stored keys, and a lookup
+ *      never allocates. Not thread safe: give each thread its own.
+ *
+ * Public Methods:
+ *                           ResultCache(size_t maxBytes)
+ *      const V*             find(std::string_view key)       - Null on a miss
+ *      void                 insert(std::string_view key, const V& value)
+ *      size_t               size()
+ *      size_t               capacity()
+ *      const CacheCounters& getCounters()
+ *
+ * Usage:
+ *      ResultCache<Fraction64> cache(64 << 20);
+ *      const Fraction64* hit = cache.find(key);
+ *      if (hit == nullptr)
+ *          cache.insert(key, compute());
+ *
+ * Notes:
+ *      - The memory limit is approximate: each entry is charged its slot, a
+ *        hash node and room for a typical key.
+ */
+template <typename V>
+class ResultCache {
+    struct Slot {
+        std::string key;            // Owned copy of the key
+        V value;                    // Cached value
+        bool referenced;            // CLOCK bit, set on every hit
+    };
+
+    std::vector<Slot> slots;                                    // Entries, never reallocated
+    std::unordered_map<std::string_view, size_t> index;         // Key (viewing slots[i].key) to slot
+    size_t maxSlots;                // Number of slots that fit in the limit
+    size_t hand;                    // Next slot the CLOCK hand looks at
+    CacheCounters counters;         // Hit, miss and eviction totals
+
+public:
+    /**
+    * Constructor
+    *
+    * Params:
+    *      size_t maxBytes : Approximate memory limit for the whole cache
+    */
+    explicit ResultCache(size_t maxBytes)
+        : maxSlots(maxBytes / (sizeof(Slot) + 96)), hand(0), counters{0, 0, 0} {
+        slots.reserve(maxSlots);
+        index.reserve(maxSlots);
+    }
+
+    /**
+    * Public : find
+    *
+    * Description:
+    *      Looks up key and marks the entry as recently used.
+    *
+    * Returns:
+    *      const V* : The cached value, or nullptr if key is not cached
+    */
+    const V* find(std::string_view key) {
+        typename std::unordered_map<std::string_view, size_t>::iterator found = index.find(key);
+        if (found == index.end()) {
+            ++counters.misses;
+            return nullptr;
+        }
+        ++counters.hits;
+        Slot& slot = slots[found->second];
+        slot.referenced = true;
+        return &slot.value;
+    }
+
+    /**
+    * Public : insert
+    *
+    * Description:
+    *      Adds a key that find() just missed. Fills empty slots first, then
+    *      runs the CLOCK hand to pick a victim.
+    */
+    void insert(std::string_view key, const V& value) {
+        if (maxSlots == 0) {
+            return;
+        }
+        size_t target;
+        if (slots.size() < maxSlots) {
+            target = slots.size();
+            slots.push_back(Slot{std::string(key), value, false});
+        } else {
+            while (slots[hand].referenced) {
+                slots[hand].referenced = false;
+                hand = hand + 1 == maxSlots ? 0 : hand + 1;
+            }
+            target = hand;
+            hand = hand + 1 == maxSlots ? 0 : hand + 1;
+            Slot& victim = slots[target];
+            index.erase(std::string_view(victim.key));
+            victim.key.assign(key.data(), key.size());
+            victim.value = value;
+            ++counters.evictions;
+        }
+        index.emplace(std::string_view(slots[target].key), target);
+    }
+
+    size_t size() const {
+        return slots.size();
+    }
+
+    size_t capacity() const {
+        return maxSlots;
+    }
+
+    const CacheCounters& getCounters() const {
+        return counters;
+    }
+};
+
+#endif
@@ -0,0 +1,186 @@
+/*****************************************************************************
+*
+*  Author:           Zachary Barrentine
+*  Email:            zlbarrentine0427@my.msutexas.edu
+*  Label:            ThreadPool Class
+*  Title:            Fixed Size Worker Pool
+*  Course:           CMPS 2143
+*  Semester:         Fall 2024
+*
+*  Description:
+*        This class keeps a fixed number of worker threads alive and hands them
+*        jobs from a shared queue. Each submitted job returns a std::future so
+*        the caller can collect results in whatever order it needs, which is how
+*        the batch evaluator keeps its output in input order.
+*
+*  Usage:
+*       - Create a ThreadPool with the number of workers wanted
+*       - Call submit() with any callable to queue a job
+*       - Call get() on the returned future to wait for the result
+*
+*  Files:
+*       thread_pool.hpp : header file containing the ThreadPool class
+*****************************************************************************/
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * ThreadPool
+ *
+ * Description:
+ *      Owns a group of worker threads that pull jobs off a FIFO queue. The
+ *      pool joins every worker when it is destroyed, after the queue drains.
+ *
+ * Public Methods:
+ *      ThreadPool(size_t threads)      - Starts the worker threads
+ *      ~ThreadPool()                   - Drains the queue and joins workers
+ *      std::future<R> submit(F job)    - Queues a job and returns its future
+ *      size_t size()                   - Number of worker threads
+ *      static size_t defaultThreads()  - Hardware thread count (at least 1)
+ *
+ * Private Methods:
+ *      void workerLoop()               - Body run by every worker thread
+ *
+ * Usage:
+ *      ThreadPool pool(4);                                   // Four workers
+ *      std::future<int> f = pool.submit([] { return 42; });  // Queue a job
+ *      int answer = f.get();                                 // Wait for it
+ */
+class ThreadPool {
+    std::vector<std::thread> workers;           // Worker threads owned by the pool
+    std::queue<std::function<void()> > jobs;    // Jobs waiting to be run
+    std::mutex queueMutex;                      // Guards jobs and stopping
+    std::condition_variable queueReady;         // Signalled when a job is queued
+    bool stopping;                              // Set by the destructor to end workers
+
+    /**
+    * Private : workerLoop
+    *
+    * Description:
+    *      Waits for jobs and runs them until the pool is stopping and the
+    *      queue is empty.
+    *
+    * Returns:
+    *      void
+    */
+    void workerLoop() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (stopping && jobs.empty()) {
+                    return;
+                }
+                job = std::move(jobs.front());
+                jobs.pop();
+            }
+            job();
+        }
+    }
+
+public:
+    /**
+    * Constructor
+    *
+    * Description:
+    *      Starts the requested number of worker threads. A count of zero is
+    *      treated as one so the pool can always make progress.
+    *
+    * Params:
+    *      size_t threads : Number of worker threads to start
+    */
+    explicit ThreadPool(size_t threads) : stopping(false) {
+        if (threads == 0) {
+            threads = 1;
+        }
+        workers.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    /**
+    * Destructor
+    *
+    * Description:
+    *      Lets the workers finish every queued job, then joins them.
+    */
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+    * Public : submit
+    *
+    * Description:
+    *      Queues a callable on the pool.
+    *
+    * Params:
+    *      F job : Callable taking no arguments
+    *
+    * Returns:
+    *      std::future<R> : Future holding the job's return value
+    */
+    template <typename F>
+    std::future<typename std::invoke_result<F>::type> submit(F job) {
+        typedef typename std::invoke_result<F>::type R;
+        std::shared_ptr<std::packaged_task<R()> > task =
+            std::make_shared<std::packaged_task<R()> >(std::move(job));
+        std::future<R> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            jobs.push([task] { (*task)(); });
+        }
+        queueReady.notify_one();
+        return result;
+    }
+
+    /**
+    * Public : size
+    *
+    * Returns:
+    *      size_t : Number of worker threads in the pool
+    */
+    size_t size() const {
+        return workers.size();
+    }
+
+    /**
+    * Public : defaultThreads
+    *
+    * Description:
+    *      Number of hardware threads, falling back to 1 when unknown.
+    *
+    * Returns:
+    *      size_t : Suggested worker count
+    */
+    static size_t defaultThreads() {
+        unsigned int n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : n;
+    }
+};
+
+#endif
@@ -96,7 +96,7 @@ class DiceViz {
             last_dice_value = (rand() % 6 + 1);  // Random number between 1 and 6
             // No need to clear the whole screen, just refresh the dice window
             draw_dice(last_dice_value);
-            Logger::log("Dice Value", to_string(last_dice_value));
+            LOG_INFO("Dice Value", last_dice_value);
             Logger::printLastLine(stdscr);
             usleep(sleep_amnt);  // 100ms delay for visual effect
             clear();
@@ -45,6 +45,9 @@ int main() {
     colorful();
 
     Logger::setFilePath("log.txt");
+    Logger::setRotation(1 << 20, 3);          // log.txt and up to 3 older logs, 1MB each
+    Logger::setRateLimit("Key pressed", 20);  // at most 20 a second in the file
+    Logger::setSampling("Dice Value", 5);     // every 5th animation frame; the status line still shows each one
 
     //made an attempt to change the property of the text from the input_class.hpp file but had trouble with static
     //Input::setTextColor(7);
@@ -59,7 +62,7 @@ int main() {
 
     size = strlen(text.c_str()) + 2;
 
-    Logger::log("vals", vector<int>({size, 3, (rows / 2), ((cols - size) / 2)}));
+    LOG_INFO("vals", size, 3, (rows / 2), ((cols - size) / 2));
 
     // Button button(text, 2, 1, Frame({size, 3, (rows / 2), ((cols - size) / 2)}));
     Button button(text, 13, 30, Frame({3, size, 10, 15})); //changed some properties of the button such as on and off colors
@@ -79,19 +82,19 @@ int main() {
             break;
         } else if (ch == KEY_MOUSE) {
             MEVENT event;
-            Logger::log("Mouse pressed", "true");
+            LOG_DEBUG("Mouse pressed", true);
             if (getmouse(&event) == OK) {
                 if (event.bstate & BUTTON1_CLICKED) {
-                    Logger::log("clicked", vector<int>({event.y, event.x}));
+                    LOG_DEBUG("clicked", event.y, event.x);
                     if (button.clicked(event.y, event.x)) {
                         button.draw_button();
-                        Logger::log("drawing button", "true");
+                        LOG_DEBUG("drawing button", true);
                         dice.animate_dice(15);      //Reduced roll time to 15
                         dice.draw_dice(dice.getLastDiceValue());
                         button.toggle();
                     }
                     if (grid.clicked(event.y, event.x - 1)) {
-                        Logger::log("clicked grid", "true");
+                        LOG_DEBUG("clicked grid", true);
                         dice.clear();
                         grid.addValue(event.y, event.x - 1, dice.getLastDiceValue());  // Mark click location
                         grid.refreshGrid();
@@ -99,7 +102,7 @@ int main() {
                 }
             }
         }
-        Logger::log("Key pressed", to_string(ch));
+        LOG_TRACE("Key pressed", ch);
         button.draw_button();
         refresh();
         ch = getch();
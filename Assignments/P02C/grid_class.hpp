@@ -20,7 +20,7 @@ class Grid {
     int values[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
 
     void init() {
-        Logger::log("Initializing grid", "true");
+        LOG_INFO("Initializing grid", true);
         cell_height = 1;
         cell_width  = 3;
         height      = 3 * (cell_height + 1) + 1;
@@ -29,13 +29,13 @@ class Grid {
         base_y      = 1;
         base_x      = 1;
 
-        Logger::log("height", vector<int>({height, width, cell_height, cell_width}));
+        LOG_DEBUG("height", height, width, cell_height, cell_width);
         drawGrid();
     }
 
    public:
     Grid(int y = 0, int x = 0) : start_y(y), start_x(x) {
-        Logger::log("yx", vector<string>{to_string(y), to_string(x)});
+        LOG_DEBUG("yx", y, x);
         init();
     }
 
@@ -123,7 +123,7 @@ class Grid {
 
     void addValue(int click_y, int click_x, int value) {
         int col = colClicked(click_y, click_x);
-        Logger::log("colClicked", to_string(col).c_str());
+        LOG_INFO("colClicked", col);
         int row          = availableRow(col);
         values[row][col] = value;
         refreshGrid();
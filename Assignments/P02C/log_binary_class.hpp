@@ -0,0 +1,441 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// The binary log format written by Logger::setBinary(true), and the code to read it back.
+//
+// A file starts with the 8 byte magic "KBLOG01\n" and is followed by records. Every record is
+// a varint byte length and then the body:
+//     key record  : 0x01, varint id, varint length, name bytes
+//     data record : 0x02, level byte, varint microseconds since the logger started,
+//                   varint key id (0 means the name follows inline as varint length + bytes),
+//                   varint value count, values
+// A key record appears before the first data record that uses its id. Each value starts with
+// a tag byte:
+//     Int (zigzag varint), UInt (varint), Bool (1 byte), Char (1 byte), Double (8 bytes),
+//     String (varint length + bytes), IntArray (varint count + zigzag varints),
+//     List (varint count + tagged values)
+// Varints are LEB128 (7 bits per byte, low bits first).
+class LogBinary {
+   public:
+    enum RecordType { KeyRecord = 1, DataRecord = 2 };
+    enum Tag { Int, UInt, Bool, Char, Double, String, IntArray, List };
+
+    static const char* magic() { return "KBLOG01\n"; }
+    static const size_t magicSize = 8;
+
+    struct Value {
+        int tag;
+        int64_t integer;              // Int, Bool and Char
+        uint64_t unsignedInteger;     // UInt
+        double real;                  // Double
+        std::string text;             // String
+        std::vector<int64_t> ints;    // IntArray
+        std::vector<Value> list;      // List
+        Value() : tag(Int), integer(0), unsignedInteger(0), real(0) {}
+    };
+
+    struct Record {
+        int type;
+        int level;
+        uint64_t micros;
+        uint32_t key;              // Key id (or the id being defined by a key record)
+        std::string name;          // Inline key name, or the name a key record defines
+        std::vector<Value> values;
+    };
+
+    // Encoding ---------------------------------------------------------------------------
+
+    // Writes v as a varint into out (at most 10 bytes) and returns its length
+    static size_t varint(char* out, uint64_t v) {
+        size_t length = 0;
+        while (v >= 0x80) {
+            out[length++] = (char)(v | 0x80);
+            v >>= 7;
+        }
+        out[length++] = (char)v;
+        return length;
+    }
+
+    static void putVarint(std::string& out, uint64_t v) {
+        char bytes[10];
+        out.append(bytes, varint(bytes, v));
+    }
+
+    static uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+
+    static void putString(std::string& out, const char* text, size_t length) {
+        putVarint(out, length);
+        out.append(text, length);
+    }
+
+    // Starts a data record in out (which is cleared); finish it with endRecord
+    static void beginData(std::string& out, int level, uint64_t micros, uint32_t key, const char* name, size_t count) {
+        out.clear();
+        out.push_back(0);  // Room for the length of a short record
+        out.push_back((char)DataRecord);
+        out.push_back((char)level);
+        putVarint(out, micros);
+        putVarint(out, key);
+        if (key == 0)
+            putString(out, name, std::strlen(name));
+        putVarint(out, count);
+    }
+
+    // Puts the length in front of the body built in out after its first (placeholder) byte
+    static void endRecord(std::string& out) {
+        size_t length = out.size() - 1;
+        if (length < 0x80) {
+            out[0] = (char)length;
+            return;
+        }
+        char bytes[10];
+        size_t size = varint(bytes, length);
+        out.replace(0, 1, bytes, size);
+    }
+
+    static void keyRecord(std::string& out, uint32_t id, const char* name) {
+        out.clear();
+        out.push_back(0);
+        out.push_back((char)KeyRecord);
+        putVarint(out, id);
+        putString(out, name, std::strlen(name));
+        endRecord(out);
+    }
+
+    static void putValue(std::string& out, const std::string& value) {
+        out.push_back((char)String);
+        putString(out, value.data(), value.size());
+    }
+
+    static void putValue(std::string& out, const char* value) {
+        if (!value)
+            value = "(null)";
+        out.push_back((char)String);
+        putString(out, value, std::strlen(value));
+    }
+
+    static void putValue(std::string& out, char value) {
+        out.push_back((char)Char);
+        out.push_back(value);
+    }
+
+    static void putValue(std::string& out, bool value) {
+        out.push_back((char)Bool);
+        out.push_back(value ? 1 : 0);
+    }
+
+    static void putValue(std::string& out, double value) {
+        char bytes[8];
+        std::memcpy(bytes, &value, 8);
+        out.push_back((char)Double);
+        out.append(bytes, 8);
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type putValue(std::string& out,
+                                                                                                         T value) {
+        out.push_back((char)Int);
+        putVarint(out, zigzag((int64_t)value));
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type putValue(std::string& out,
+                                                                                                           T value) {
+        out.push_back((char)UInt);
+        putVarint(out, (uint64_t)value);
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type putValue(std::string& out, T value) {
+        putValue(out, (double)value);
+    }
+
+    // Vectors of signed integers are packed; any other vector becomes a list of tagged values
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type putValue(
+        std::string& out, const std::vector<T>& values) {
+        out.push_back((char)IntArray);
+        putVarint(out, values.size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            putVarint(out, zigzag((int64_t)values[i]));
+        }
+    }
+
+    template <typename T>
+    static typename std::enable_if<!(std::is_integral<T>::value && std::is_signed<T>::value)>::type putValue(
+        std::string& out, const std::vector<T>& values) {
+        out.push_back((char)List);
+        putVarint(out, values.size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            putValue(out, (const T&)values[i]);  // The cast keeps vector<bool> proxies working
+        }
+    }
+
+    // Decoding ---------------------------------------------------------------------------
+
+    // Reads one record starting at p and moves p past it. Returns false (leaving p alone) if
+    // the record is cut short or does not parse.
+    static bool readRecord(const char*& p, const char* end, Record& record) {
+        const char* at = p;
+        uint64_t length;
+        if (!getVarint(at, end, length) || length > (uint64_t)(end - at))
+            return false;
+        const char* bodyEnd = at + length;
+        if (!readBody(at, bodyEnd, record) || at != bodyEnd)
+            return false;
+        p = bodyEnd;
+        return true;
+    }
+
+    // The record as Logger would have written it in text mode (without the '\n')
+    static void formatText(const Record& record, const std::string& key, std::string& out) {
+        out.append(key);
+        if (record.values.size() == 1) {
+            out.append(": ");
+            formatValue(record.values[0], out);
+        } else if (record.values.size() > 1) {
+            out.append(": [");
+            for (size_t i = 0; i < record.values.size(); ++i) {
+                if (i != 0)
+                    out.append(", ");
+                formatValue(record.values[i], out);
+            }
+            out.push_back(']');
+        }
+    }
+
+    // The record as one JSON object (without the '\n')
+    static void formatJson(const Record& record, const std::string& key, std::string& out) {
+        static const char* levels[] = {"trace", "debug", "info", "warn", "error"};
+        char number[32];
+        snprintf(number, sizeof(number), "%llu", (unsigned long long)record.micros);
+        out.append("{\"time_us\": ").append(number).append(", \"level\": ");
+        if (record.level >= 0 && record.level < 5) {
+            out.push_back('"');
+            out.append(levels[record.level]).push_back('"');
+        } else {
+            snprintf(number, sizeof(number), "%d", record.level);
+            out.append(number);
+        }
+        out.append(", \"key\": ");
+        jsonString(key, out);
+        out.append(", \"values\": [");
+        for (size_t i = 0; i < record.values.size(); ++i) {
+            if (i != 0)
+                out.append(", ");
+            jsonValue(record.values[i], out);
+        }
+        out.append("]}");
+    }
+
+   private:
+    static bool getVarint(const char*& p, const char* end, uint64_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 64 && p < end; shift += 7) {
+            unsigned char byte = (unsigned char)*p++;
+            v |= (uint64_t)(byte & 0x7f) << shift;
+            if (byte < 0x80)
+                return true;
+        }
+        return false;
+    }
+
+    static int64_t unzigzag(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+    static bool getString(const char*& p, const char* end, std::string& text) {
+        uint64_t length;
+        if (!getVarint(p, end, length) || length > (uint64_t)(end - p))
+            return false;
+        text.assign(p, (size_t)length);
+        p += length;
+        return true;
+    }
+
+    static bool readBody(const char*& p, const char* end, Record& record) {
+        if (p == end)
+            return false;
+        record.type = (unsigned char)*p++;
+        record.level = 0;
+        record.micros = 0;
+        record.name.clear();
+        record.values.clear();
+        uint64_t v;
+        if (record.type == KeyRecord) {
+            if (!getVarint(p, end, v))
+                return false;
+            record.key = (uint32_t)v;
+            return getString(p, end, record.name);
+        }
+        if (record.type != DataRecord || p == end)
+            return false;
+        record.level = (unsigned char)*p++;
+        if (!getVarint(p, end, record.micros) || !getVarint(p, end, v))
+            return false;
+        record.key = (uint32_t)v;
+        if (record.key == 0 && !getString(p, end, record.name))
+            return false;
+        uint64_t count;
+        if (!getVarint(p, end, count) || count > (uint64_t)(end - p))
+            return false;
+        record.values.resize((size_t)count);
+        for (size_t i = 0; i < count; ++i) {
+            if (!readValue(p, end, record.values[i], 0))
+                return false;
+        }
+        return true;
+    }
+
+    static bool readValue(const char*& p, const char* end, Value& value, int depth) {
+        if (p == end || depth > 16)
+            return false;
+        value.tag = (unsigned char)*p++;
+        uint64_t v;
+        switch (value.tag) {
+            case Int:
+                if (!getVarint(p, end, v))
+                    return false;
+                value.integer = unzigzag(v);
+                return true;
+            case UInt:
+                return getVarint(p, end, value.unsignedInteger);
+            case Bool:
+            case Char:
+                if (p == end)
+                    return false;
+                value.integer = (unsigned char)*p++;
+                return true;
+            case Double:
+                if (end - p < 8)
+                    return false;
+                std::memcpy(&value.real, p, 8);
+                p += 8;
+                return true;
+            case String:
+                return getString(p, end, value.text);
+            case IntArray:
+                if (!getVarint(p, end, v) || v > (uint64_t)(end - p))
+                    return false;
+                value.ints.resize((size_t)v);
+                for (size_t i = 0; i < value.ints.size(); ++i) {
+                    uint64_t element;
+                    if (!getVarint(p, end, element))
+                        return false;
+                    value.ints[i] = unzigzag(element);
+                }
+                return true;
+            case List:
+                if (!getVarint(p, end, v) || v > (uint64_t)(end - p))
+                    return false;
+                value.list.resize((size_t)v);
+                for (size_t i = 0; i < value.list.size(); ++i) {
+                    if (!readValue(p, end, value.list[i], depth + 1))
+                        return false;
+                }
+                return true;
+        }
+        return false;
+    }
+
+    static void formatValue(const Value& value, std::string& out) {
+        char number[32];
+        switch (value.tag) {
+            case Int:
+                snprintf(number, sizeof(number), "%lld", (long long)value.integer);
+                out.append(number);
+                break;
+            case UInt:
+                snprintf(number, sizeof(number), "%llu", (unsigned long long)value.unsignedInteger);
+                out.append(number);
+                break;
+            case Bool:
+                out.append(value.integer ? "true" : "false");
+                break;
+            case Char:
+                out.push_back((char)value.integer);
+                break;
+            case Double:
+                snprintf(number, sizeof(number), "%g", value.real);
+                out.append(number);
+                break;
+            case String:
+                out.append(value.text);
+                break;
+            case IntArray:
+                out.push_back('[');
+                for (size_t i = 0; i < value.ints.size(); ++i) {
+                    snprintf(number, sizeof(number), i ? ", %lld" : "%lld", (long long)value.ints[i]);
+                    out.append(number);
+                }
+                out.push_back(']');
+                break;
+            case List:
+                out.push_back('[');
+                for (size_t i = 0; i < value.list.size(); ++i) {
+                    if (i != 0)
+                        out.append(", ");
+                    formatValue(value.list[i], out);
+                }
+                out.push_back(']');
+                break;
+        }
+    }
+
+    static void jsonString(const std::string& text, std::string& out) {
+        out.push_back('"');
+        for (size_t i = 0; i < text.size(); ++i) {
+            unsigned char c = (unsigned char)text[i];
+            if (c == '"' || c == '\\') {
+                out.push_back('\\');
+                out.push_back((char)c);
+            } else if (c < 0x20) {
+                char escape[8];
+                snprintf(escape, sizeof(escape), "\\u%04x", c);
+                out.append(escape);
+            } else {
+                out.push_back((char)c);
+            }
+        }
+        out.push_back('"');
+    }
+
+    static void jsonValue(const Value& value, std::string& out) {
+        switch (value.tag) {
+            case Char:
+            case String: {
+                std::string text;
+                formatValue(value, text);
+                jsonString(text, out);
+                break;
+            }
+            case Double:
+                if (std::isfinite(value.real)) {
+                    char number[32];
+                    snprintf(number, sizeof(number), "%.17g", value.real);
+                    out.append(number);
+                } else {
+                    out.append("null");
+                }
+                break;
+            case List:
+                out.push_back('[');
+                for (size_t i = 0; i < value.list.size(); ++i) {
+                    if (i != 0)
+                        out.append(", ");
+                    jsonValue(value.list[i], out);
+                }
+                out.push_back(']');
+                break;
+            default:  // Numbers, bools and int arrays read the same in JSON
+                formatValue(value, out);
+                break;
+        }
+    }
+};
@@ -0,0 +1,75 @@
+#include "log_binary_class.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+// Turns a binary log written by Logger::setBinary(true) back into the text the Logger writes
+// in text mode, or into one JSON object per record with --json.
+//
+//     ./log_decode log.bin > log.txt
+//     ./log_decode --json log.bin > log.json
+int main(int argc, char* argv[]) {
+    bool json  = false;
+    string path;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--json") == 0)
+            json = true;
+        else
+            path = argv[i];
+    }
+    if (path.empty()) {
+        cerr << "Usage: " << argv[0] << " [--json] LOGFILE\n";
+        return 1;
+    }
+
+    ifstream file(path.c_str(), ios::binary);
+    if (!file.is_open()) {
+        cerr << "Unable to open file: " << path << endl;
+        return 1;
+    }
+    string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    if (data.size() < LogBinary::magicSize || data.compare(0, LogBinary::magicSize, LogBinary::magic()) != 0) {
+        cerr << path << " is not a binary log\n";
+        return 1;
+    }
+
+    unordered_map<uint32_t, string> keys;  // Name of each key id, read from the file so not trusted to be dense
+    const char* p   = data.data() + LogBinary::magicSize;
+    const char* end = data.data() + data.size();
+    LogBinary::Record record;
+    string out;
+    while (p < end) {
+        if (!LogBinary::readRecord(p, end, record)) {
+            cerr << path << ": stopped at byte " << (p - data.data()) << ", the rest is cut short or damaged\n";
+            fwrite(out.data(), 1, out.size(), stdout);
+            return 1;
+        }
+        if (record.type == LogBinary::KeyRecord) {
+            if (record.key != 0)
+                keys[record.key] = record.name;
+            continue;
+        }
+        string key = record.name;
+        if (record.key != 0) {
+            unordered_map<uint32_t, string>::const_iterator found = keys.find(record.key);
+            key = found != keys.end() ? found->second : "key#" + to_string(record.key);
+        }
+        if (json)
+            LogBinary::formatJson(record, key, out);
+        else
+            LogBinary::formatText(record, key, out);
+        out.push_back('\n');
+        if (out.size() >= (1 << 16)) {
+            fwrite(out.data(), 1, out.size(), stdout);
+            out.clear();
+        }
+    }
+    fwrite(out.data(), 1, out.size(), stdout);
+    return 0;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+// Bounded multi-producer ring of formatted log records (Vyukov's sequence-numbered queue).
+// Any thread can push without taking a lock; only the Logger's writer thread (or a crash
+// handler that has taken the drain flag) pops. Records that do not fit in a slot are kept
+// in a heap string instead, so nothing is ever cut short.
+class LogRing {
+   public:
+    static const size_t slotText = 240;  // Bytes of text stored inline in each slot
+
+    struct Slot {
+        std::atomic<size_t> sequence;  // Tells producers and the consumer whose turn the slot is
+        size_t length;
+        std::string *overflow;  // Set when the record is longer than slotText
+        char text[slotText];
+    };
+
+    // capacity is rounded up to a power of two
+    explicit LogRing(size_t capacity) : mask(0), head(0), tail(0) {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        mask = size - 1;
+        slots.reset(new Slot[size]);
+        for (size_t i = 0; i < size; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+            slots[i].length   = 0;
+            slots[i].overflow = nullptr;
+        }
+    }
+
+    ~LogRing() {
+        for (size_t i = 0; i <= mask; ++i) {
+            delete slots[i].overflow;
+        }
+    }
+
+    // Copies a record into the next free slot. Returns false if the ring is full.
+    bool tryPush(const char *data, size_t length) {
+        size_t position = head.load(std::memory_order_relaxed);
+        Slot *slot;
+        while (true) {
+            slot          = &slots[position & mask];
+            size_t seq    = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)position;
+            if (diff == 0) {
+                if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // The consumer has not freed this slot yet
+            } else {
+                position = head.load(std::memory_order_relaxed);
+            }
+        }
+        if (length <= slotText) {
+            std::memcpy(slot->text, data, length);
+            slot->overflow = nullptr;
+        } else {
+            slot->overflow = new std::string(data, length);
+        }
+        slot->length = length;
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Returns the oldest published record without removing it, or nullptr if there is none.
+    // Only the thread that holds the drain flag may call front(), pop() and skip().
+    const Slot *front() const {
+        const Slot *slot = &slots[tail & mask];
+        if (slot->sequence.load(std::memory_order_acquire) != tail + 1) {
+            return nullptr;
+        }
+        return slot;
+    }
+
+    // Frees the slot returned by front()
+    void pop() {
+        Slot *slot = &slots[tail & mask];
+        delete slot->overflow;
+        slot->overflow = nullptr;
+        release();
+    }
+
+    // Frees the slot returned by front() without deleting its overflow string, which is
+    // leaked instead. free() is not async-signal-safe, so this is the pop for signal handlers.
+    void skip() {
+        slots[tail & mask].overflow = nullptr;
+        release();
+    }
+
+    // Records claimed by producers so far (some may still be being copied in)
+    size_t pushed() const { return head.load(std::memory_order_acquire); }
+
+    // Records popped so far
+    size_t popped() const { return tail; }
+
+    static const char *textOf(const Slot *slot) { return slot->overflow ? slot->overflow->data() : slot->text; }
+
+   private:
+    // Hands the slot at tail back to the producers
+    void release() {
+        slots[tail & mask].sequence.store(tail + mask + 1, std::memory_order_release);
+        ++tail;
+    }
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head;  // Next slot a producer will claim
+    alignas(64) size_t tail;               // Next slot the consumer will read
+};
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// The most recent log lines, kept in memory so the status line and log panels can be drawn
+// without reading the log file back. Fixed-size slots are allocated once; a line longer than
+// lineText is kept only up to that length, which is wider than any window it is drawn in.
+// In binary log mode the entries are encoded records, which the Logger decodes when drawn.
+//
+// Every log call pushes here, so pushing takes no lock. Each line gets a ticket from one
+// atomic counter and goes in slot ticket % capacity, guarded by a sequence number the way a
+// seqlock is: odd while the line is being written, 2 * (ticket + 1) once it is complete.
+// Readers copy a slot and keep the copy only if its sequence was the same before and after,
+// so a line that is overwritten while it is read is skipped instead of shown torn.
+class LogTail {
+   public:
+    static const size_t lineText = 160;  // Bytes of each line that are kept
+
+    explicit LogTail(size_t capacity) : capacity(capacity ? capacity : 1), next(0), first(0) {
+        lines.reset(new Line[this->capacity]);
+        for (size_t i = 0; i < this->capacity; ++i) {
+            lines[i].sequence.store(0, std::memory_order_relaxed);
+            lines[i].length.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Adds one line (without its '\n') or binary record, replacing the oldest once the tail is
+    // full. If the slot is still being written by a push a whole lap behind, this line is
+    // dropped rather than waited for.
+    void push(const char* data, size_t length, bool binary = false) {
+        if (length > lineText)
+            length = lineText;
+        size_t ticket = next.fetch_add(1, std::memory_order_relaxed);
+        Line& line    = lines[ticket % capacity];
+        size_t seq    = line.sequence.load(std::memory_order_relaxed);
+        do {
+            if ((seq & 1) != 0 || seq >= 2 * (ticket + 1))
+                return;  // Another push is writing the slot, or a newer line already took it
+        } while (!line.sequence.compare_exchange_weak(seq, 2 * ticket + 1, std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i * 8 < length; ++i) {
+            uint64_t word = 0;
+            std::memcpy(&word, data + i * 8, length - i * 8 < 8 ? length - i * 8 : 8);
+            line.words[i].store(word, std::memory_order_relaxed);
+        }
+        line.length.store(length | (binary ? binaryBit : 0), std::memory_order_relaxed);
+        line.sequence.store(2 * (ticket + 1), std::memory_order_release);
+    }
+
+    // Adds every line of a record
+    void pushLines(const char* data, size_t length) {
+        size_t start = 0;
+        for (size_t i = 0; i < length; ++i) {
+            if (data[i] == '\n') {
+                push(data + start, i - start);
+                start = i + 1;
+            }
+        }
+        if (start < length)
+            push(data + start, length - start);
+    }
+
+    // The newest k entries, oldest first (fewer if not that many have been logged). If binary
+    // is given, it is filled with which of them are binary records.
+    std::vector<std::string> last(size_t k, std::vector<bool>* binary = nullptr) const {
+        std::vector<std::string> result;
+        if (binary)
+            binary->clear();
+        char text[lineText];
+        size_t end    = next.load(std::memory_order_acquire);
+        size_t oldest = oldestTicket(end);
+        for (size_t ticket = end; ticket > oldest && result.size() < k; --ticket) {
+            bool isBinary;
+            size_t length;
+            if (copy(ticket - 1, text, length, isBinary)) {
+                result.push_back(std::string(text, length));
+                if (binary)
+                    binary->push_back(isBinary);
+            }
+        }
+        std::reverse(result.begin(), result.end());
+        if (binary)
+            std::reverse(binary->begin(), binary->end());
+        return result;
+    }
+
+    // Copies the newest entry into buffer (NUL terminated, cut to size) without allocating.
+    // Returns its length, 0 if nothing has been logged.
+    size_t copyLast(char* buffer, size_t size, bool* binary = nullptr) const {
+        if (size == 0)
+            return 0;
+        char text[lineText];
+        size_t length = 0;
+        bool isBinary = false;
+        size_t end    = next.load(std::memory_order_acquire);
+        size_t oldest = oldestTicket(end);
+        for (size_t ticket = end; ticket > oldest; --ticket) {
+            if (copy(ticket - 1, text, length, isBinary))
+                break;
+            length   = 0;
+            isBinary = false;
+        }
+        if (length > size - 1)
+            length = size - 1;
+        std::memcpy(buffer, text, length);
+        buffer[length] = '\0';
+        if (binary)
+            *binary = isBinary;
+        return length;
+    }
+
+    // Forgets every entry so far. Lines still being pushed when this is called may stay.
+    void clear() { first.store(next.load(std::memory_order_acquire), std::memory_order_release); }
+
+   private:
+    static const size_t binaryBit = (size_t)1 << (sizeof(size_t) * 8 - 1);  // Set in length for binary records
+
+    struct Line {
+        std::atomic<size_t> sequence;  // Odd while written, 2 * (ticket + 1) once complete
+        std::atomic<size_t> length;    // Bytes kept, with binaryBit for binary records
+        std::atomic<uint64_t> words[lineText / 8];
+    };
+
+    // The first ticket still worth reading when end tickets have been handed out
+    size_t oldestTicket(size_t end) const {
+        size_t oldest = first.load(std::memory_order_acquire);
+        if (end - oldest > capacity)
+            oldest = end - capacity;
+        return oldest;
+    }
+
+    // Copies the line with the given ticket. False if it was never completed, was replaced,
+    // or changed while it was being copied.
+    bool copy(size_t ticket, char* text, size_t& length, bool& binary) const {
+        const Line& line = lines[ticket % capacity];
+        size_t seq       = line.sequence.load(std::memory_order_acquire);
+        if (seq != 2 * (ticket + 1))
+            return false;
+        size_t stored = line.length.load(std::memory_order_relaxed);
+        length        = stored & ~binaryBit;
+        binary        = (stored & binaryBit) != 0;
+        if (length > lineText)
+            return false;
+        for (size_t i = 0; i * 8 < length; ++i) {
+            uint64_t word = line.words[i].load(std::memory_order_relaxed);
+            std::memcpy(text + i * 8, &word, length - i * 8 < 8 ? length - i * 8 : 8);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return line.sequence.load(std::memory_order_relaxed) == seq;
+    }
+
+    std::unique_ptr<Line[]> lines;
+    size_t capacity;
+    std::atomic<size_t> next;   // Ticket the next line gets
+    std::atomic<size_t> first;  // Tickets below this were cleared
+};
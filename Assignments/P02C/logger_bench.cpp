@@ -0,0 +1,248 @@
+#include <sys/stat.h>
+
+#include "logger_class.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+typedef chrono::steady_clock Clock;
+
+// Measures how Logger behaves when several threads log at once. For each backend and each
+// log overload it runs 1, 2, 4, ... up to the given number of threads, every thread making the
+// same number of calls, and reports records a second (including the final flush), call latency
+// percentiles and the bytes that reached the file. Backends:
+//     text   : Logger writing text lines
+//     binary : Logger writing binary records (Logger::setBinary)
+//     sync   : the original Logger, which opened the file and wrote each record under a mutex
+//
+//     g++ -std=c++11 -O2 -pthread -o logger_bench logger_bench.cpp -lncurses
+//     ./logger_bench --threads 8 --records 100000
+//     ./logger_bench --backend text --csv > before.csv
+
+// The Logger as it was before records went through the ring: every call opens the file,
+// appends one line and flushes it, holding fileMutex throughout.
+class SyncLogger {
+   public:
+    static void setFilePath(const string& filename) { filePath = filename; }
+
+    static void log(const string& key, const string& value) {
+        lock_guard<mutex> lock(fileMutex);
+        ofstream file(filePath, ios::app);
+        file << key << ": " << value << endl;
+    }
+
+    static void log(const string& key, const vector<string>& values) {
+        lock_guard<mutex> lock(fileMutex);
+        ofstream file(filePath, ios::app);
+        file << key << ": [";
+        for (size_t i = 0; i < values.size(); ++i) {
+            file << values[i];
+            if (i != values.size() - 1)
+                file << ", ";
+        }
+        file << "]" << endl;
+    }
+
+    static void log(const string& key, const vector<int>& values) {
+        lock_guard<mutex> lock(fileMutex);
+        ofstream file(filePath, ios::app);
+        file << key << ": [";
+        for (size_t i = 0; i < values.size(); ++i) {
+            file << values[i];
+            if (i != values.size() - 1)
+                file << ", ";
+        }
+        file << "]" << endl;
+    }
+
+    static void log(const map<string, string>& keyValuePairs) {
+        lock_guard<mutex> lock(fileMutex);
+        ofstream file(filePath, ios::app);
+        for (const auto& pair : keyValuePairs) {
+            file << pair.first << ": " << pair.second << endl;
+        }
+    }
+
+   private:
+    static string filePath;
+    static mutex fileMutex;
+};
+
+string SyncLogger::filePath = "log.txt";
+mutex SyncLogger::fileMutex;
+
+enum Backend { Text, Binary, Sync };
+enum Overload { Variadic, KeyString, KeyStrings, KeyInts, KeyMap, OverloadCount };
+
+const char* backendNames[]  = {"text", "binary", "sync"};
+const char* overloadNames[] = {"log(level, key, ints...)", "log(key, string)", "log(key, vector<string>)",
+                               "log(key, vector<int>)", "log(map)"};
+
+// One call of the given overload. The arguments are built the way the game's call sites build
+// them, so their cost is part of the measurement. The sync backend has no variadic log, so it
+// gets the vector<int> call that the variadic one replaced.
+void callLogger(Backend backend, Overload overload, int thread, int i) {
+    switch (overload) {
+        case Variadic:
+            if (backend == Sync)
+                SyncLogger::log("clicked", vector<int>({thread, i}));
+            else
+                Logger::log(LogLevel::Info, "clicked", thread, i);
+            break;
+        case KeyString:
+            if (backend == Sync)
+                SyncLogger::log("Dice Value", to_string(i % 6 + 1));
+            else
+                Logger::log("Dice Value", to_string(i % 6 + 1));
+            break;
+        case KeyStrings:
+            if (backend == Sync)
+                SyncLogger::log("yx", vector<string>{to_string(thread), to_string(i)});
+            else
+                Logger::log("yx", vector<string>{to_string(thread), to_string(i)});
+            break;
+        case KeyInts:
+            if (backend == Sync)
+                SyncLogger::log("clicked", vector<int>({thread, i}));
+            else
+                Logger::log("clicked", vector<int>({thread, i}));
+            break;
+        case KeyMap: {
+            map<string, string> pairs;
+            pairs["thread"] = to_string(thread);
+            pairs["i"]      = to_string(i);
+            if (backend == Sync)
+                SyncLogger::log(pairs);
+            else
+                Logger::log(pairs);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+struct Result {
+    double recordsPerSecond;
+    double p50, p99, p999;  // Call latency in microseconds
+    long long bytes;
+};
+
+double percentile(vector<uint32_t>& nanos, double fraction) {
+    if (nanos.empty())
+        return 0;
+    size_t index = (size_t)(fraction * (nanos.size() - 1));
+    nth_element(nanos.begin(), nanos.begin() + index, nanos.end());
+    return nanos[index] / 1000.0;
+}
+
+Result run(Backend backend, Overload overload, int threads, int records, const string& path) {
+    ::unlink(path.c_str());
+    if (backend == Sync) {
+        SyncLogger::setFilePath(path);
+    } else {
+        Logger::setFilePath(path);
+        Logger::setBinary(backend == Binary);
+    }
+
+    vector<vector<uint32_t> > latencies(threads, vector<uint32_t>(records));
+    vector<thread> workers;
+    Clock::time_point start = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.push_back(thread([=, &latencies] {
+            vector<uint32_t>& mine = latencies[t];
+            for (int i = 0; i < records; ++i) {
+                Clock::time_point before = Clock::now();
+                callLogger(backend, overload, t, i);
+                mine[i] = (uint32_t)min<long long>(
+                    chrono::duration_cast<chrono::nanoseconds>(Clock::now() - before).count(), 0xffffffffLL);
+            }
+        }));
+    }
+    for (size_t t = 0; t < workers.size(); ++t) {
+        workers[t].join();
+    }
+    if (backend != Sync)
+        Logger::flush();  // Counted: the records are not logged until they are in the file
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+    vector<uint32_t> all;
+    all.reserve((size_t)threads * records);
+    for (int t = 0; t < threads; ++t) {
+        all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+    }
+    struct stat status;
+    Result result;
+    result.recordsPerSecond = (double)threads * records / seconds;
+    result.p50              = percentile(all, 0.50);
+    result.p99              = percentile(all, 0.99);
+    result.p999             = percentile(all, 0.999);
+    result.bytes            = stat(path.c_str(), &status) == 0 ? (long long)status.st_size : -1;
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    int maxThreads = (int)thread::hardware_concurrency();
+    int records    = 100000;
+    string dir     = "/tmp";
+    string only;
+    bool csv = false;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc)
+            maxThreads = atoi(argv[++i]);
+        else if (arg == "--records" && i + 1 < argc)
+            records = atoi(argv[++i]);
+        else if (arg == "--dir" && i + 1 < argc)
+            dir = argv[++i];
+        else if (arg == "--backend" && i + 1 < argc)
+            only = argv[++i];
+        else if (arg == "--csv")
+            csv = true;
+        else {
+            fprintf(stderr, "Usage: %s [--threads N] [--records R] [--dir DIR] [--backend text|binary|sync] [--csv]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (maxThreads < 1)
+        maxThreads = 1;
+    if (records < 1)
+        records = 1;
+
+    if (csv)
+        printf("backend,overload,threads,records_per_s,p50_us,p99_us,p999_us,bytes\n");
+    else
+        printf("%-7s %-26s %7s %14s %9s %9s %9s %12s\n", "backend", "overload", "threads", "records/s", "p50 us",
+               "p99 us", "p999 us", "bytes");
+    for (int b = Text; b <= Sync; ++b) {
+        if (!only.empty() && only != backendNames[b])
+            continue;
+        string path = dir + "/logger_bench." + backendNames[b];
+        for (int o = 0; o < OverloadCount; ++o) {
+            for (int threads = 1;; threads = min(threads * 2, maxThreads)) {
+                Result r = run((Backend)b, (Overload)o, threads, records, path);
+                if (csv)
+                    printf("%s,%s,%d,%.0f,%.3f,%.3f,%.3f,%lld\n", backendNames[b], overloadNames[o], threads,
+                           r.recordsPerSecond, r.p50, r.p99, r.p999, r.bytes);
+                else
+                    printf("%-7s %-26s %7d %14.0f %9.3f %9.3f %9.3f %12lld\n", backendNames[b], overloadNames[o],
+                           threads, r.recordsPerSecond, r.p50, r.p99, r.p999, r.bytes);
+                fflush(stdout);
+                if (threads == maxThreads)
+                    break;
+            }
+        }
+        ::unlink(path.c_str());
+    }
+    return 0;
+}
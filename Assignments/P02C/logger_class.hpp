@@ -1,130 +1,832 @@
 #pragma once
+#include <fcntl.h>
 #include <ncurses.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-#include <fstream>
-#include <iostream>
+#include "log_binary_class.hpp"
+#include "log_ring_class.hpp"
+#include "log_tail_class.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
 #include <map>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
+// Records below this level are removed at compile time: build with -DLOGGER_MIN_LEVEL=2 to keep
+// only Info and above. Calls made through the LOG_TRACE ... LOG_ERROR macros below that level
+// expand to nothing, so not even their arguments are evaluated. Logger::log(level, ...) with a
+// level below it returns at once, but its arguments are still built by the caller.
+#ifndef LOGGER_MIN_LEVEL
+#define LOGGER_MIN_LEVEL 0
+#endif
+
+enum class LogLevel : int { Trace, Debug, Info, Warn, Error, Off };
+
+// LOG_DEBUG("clicked", y, x) is Logger::log(LogLevel::Debug, "clicked", y, x), or nothing at all
+// when LOGGER_MIN_LEVEL is above Debug
+#if LOGGER_MIN_LEVEL <= 0
+#define LOG_TRACE(...) Logger::log(LogLevel::Trace, __VA_ARGS__)
+#else
+#define LOG_TRACE(...) ((void)0)
+#endif
+#if LOGGER_MIN_LEVEL <= 1
+#define LOG_DEBUG(...) Logger::log(LogLevel::Debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+#if LOGGER_MIN_LEVEL <= 2
+#define LOG_INFO(...) Logger::log(LogLevel::Info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+#if LOGGER_MIN_LEVEL <= 3
+#define LOG_WARN(...) Logger::log(LogLevel::Warn, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+#if LOGGER_MIN_LEVEL <= 4
+#define LOG_ERROR(...) Logger::log(LogLevel::Error, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+
+// Callers format a record and push it into a lock-free ring; a background writer thread
+// drains the ring and appends whole batches to a log file it keeps open. The ring is
+// drained on shutdown (when the program exits) and from the handlers of crash signals, so
+// records logged right before a crash still reach the file.
+//
+// In binary mode (setBinary) records are written in the compact format described in
+// log_binary_class.hpp instead of as text; log_decode turns such a file back into text or JSON.
+//
+// Busy keys can be thinned out with setRateLimit and setSampling. Records a limit holds back
+// still reach the in-memory tail (so the status line stays current) but not the file; the
+// writer logs how many were held back for each key once a second as "suppressed: [key, n]".
+// setRotation caps the size of the log and how many old logs are kept.
 class Logger {
    public:
     // Set the log file path
-    static void setFilePath(const std::string& filename) { filePath = filename; }
+    static void setFilePath(const std::string& filename) {
+        flush();
+        std::lock_guard<std::mutex> lock(fileMutex);
+        closeFile();
+        filePath = filename;
+    }
 
     static void clearLogFile() {
-        if (!logging)
+        if (!enabled(LogLevel::Error))
             return;
+        flush();
         std::lock_guard<std::mutex> lock(fileMutex);  // Thread-safe access
-        std::ofstream file(filePath, std::ios::trunc);
-        if (file.is_open()) {
-            file << "Log file cleared." << std::endl;
+        tail.clear();
+        if (binary) {
+            // The key is written inline: registering it could wait on the writer, which needs fileMutex
+            std::string record;
+            LogBinary::beginData(record, (int)LogLevel::Info, now(), 0, "Log file cleared.", 0);
+            LogBinary::endRecord(record);
+            if (openFile() && ftruncate(fd, 0) == 0) {
+                writeHeader();
+                writeAll(fd, record.data(), record.size());
+                closeFile();  // Reopening measures the new size and header
+            }
+            tail.push(record.data(), record.size(), true);
+            return;
+        }
+        if (openFile() && ftruncate(fd, 0) == 0) {
+            writeAll(fd, "Log file cleared.\n", 18);
+            fileSize = 18;
         }
+        tail.push("Log file cleared.", 17);
+    }
+
+    // At most perSecond records a second with this key go to the file (0 removes the limit).
+    // Returns false if maxLimits other keys already have limits, leaving this key unlimited.
+    static bool setRateLimit(const char* key, unsigned perSecond) {
+        KeyLimit* limit = keyLimit(key);
+        if (limit == nullptr)
+            return false;
+        limit->perSecond.store(perSecond, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Only every nth record with this key goes to the file (1 writes them all). Returns false
+    // if maxLimits other keys already have limits, leaving this key unlimited.
+    static bool setSampling(const char* key, unsigned n) {
+        KeyLimit* limit = keyLimit(key);
+        if (limit == nullptr)
+            return false;
+        limit->everyN.store(n, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Starts a new file once the log would grow past maxBytes (0 never does). The old file
+    // becomes "path.1", the one before that "path.2", and so on up to "path.<keep>"; older
+    // ones are deleted. A file only goes over maxBytes if a single batch is larger than that.
+    static void setRotation(size_t maxBytes, unsigned keep) {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        rotateBytes.store(maxBytes, std::memory_order_relaxed);
+        keepFiles = keep;
+    }
+
+    // Switches between text and binary records. Give each format its own file: the binary
+    // header is only written at the start of an empty file.
+    static void setBinary(bool on) {
+        flush();
+        std::lock_guard<std::mutex> lock(fileMutex);
+        closeFile();
+        binary = on;
+    }
+
+    // Records below level are skipped at run time; LogLevel::Off turns logging off
+    static void setLevel(LogLevel level) { threshold.store((int)level, std::memory_order_relaxed); }
+
+    static bool enabled(LogLevel level) {
+        return (int)level >= LOGGER_MIN_LEVEL && (int)level >= threshold.load(std::memory_order_relaxed);
+    }
+
+    // Logs "key: value" for one value, "key: [a, b, ...]" for several and just "key" for none.
+    // Values can be strings, characters, bools, numbers or vectors of those. Nothing is
+    // formatted unless the level is enabled, and the text is built in a per-thread buffer
+    // that keeps its capacity, so an enabled call does not allocate either.
+    template <typename... Args>
+    static void log(LogLevel level, const char* key, const Args&... args) {
+        if (!enabled(level))
+            return;
+        bool toFile       = admit(key);
+        std::string& line = lineBuffer();
+        if (binary.load(std::memory_order_relaxed)) {
+            LogBinary::beginData(line, (int)level, now(), keyId(key), key, sizeof...(Args));
+            putValues(line, args...);
+            LogBinary::endRecord(line);
+            pushBinary(line, toFile);
+            return;
+        }
+        line.clear();
+        line.append(key);
+        if (sizeof...(Args) > 0)
+            line.append(": ");
+        appendValues(line, args...);
+        line.push_back('\n');
+        push(line, toFile);
     }
 
     // Log a single key-value pair (string, string)
     static void log(const std::string& key, const std::string& value) {
-        if (!logging)
+        if (!enabled(LogLevel::Info))
             return;
-        std::lock_guard<std::mutex> lock(fileMutex);  // Thread-safe access
-        std::ofstream file(filePath, std::ios::app);
-        if (file.is_open()) {
-            file << key << ": " << value << std::endl;
-        }
+        if (binary)
+            return log(LogLevel::Info, key.c_str(), value);
+        std::string line;
+        line.reserve(key.size() + value.size() + 3);
+        line.append(key).append(": ").append(value).push_back('\n');
+        push(line, admit(key.c_str()));
     }
 
     // Log multiple values under a single key (string, vector<string>)
     static void log(const std::string& key, const std::vector<std::string>& values) {
-        if (!logging)
+        if (!enabled(LogLevel::Info))
             return;
-        std::lock_guard<std::mutex> lock(fileMutex);  // Thread-safe access
-        std::ofstream file(filePath, std::ios::app);
-        if (file.is_open()) {
-            file << key << ": [";
-            for (size_t i = 0; i < values.size(); ++i) {
-                file << values[i];
-                if (i != values.size() - 1)
-                    file << ", ";
-            }
-            file << "]" << std::endl;
+        if (binary)
+            return log(LogLevel::Info, key.c_str(), values);
+        std::string line = key + ": [";
+        for (size_t i = 0; i < values.size(); ++i) {
+            line += values[i];
+            if (i != values.size() - 1)
+                line += ", ";
         }
+        line += "]\n";
+        push(line, admit(key.c_str()));
     }
 
     static void log(const std::string& key, const std::vector<int>& values) {
-        if (!logging)
+        if (!enabled(LogLevel::Info))
             return;
-        std::lock_guard<std::mutex> lock(fileMutex);  // Thread-safe access
-        std::ofstream file(filePath, std::ios::app);
-        if (file.is_open()) {
-            file << key << ": [";
-            for (size_t i = 0; i < values.size(); ++i) {
-                file << values[i];
-                if (i != values.size() - 1)
-                    file << ", ";
-            }
-            file << "]" << std::endl;
+        if (binary)
+            return log(LogLevel::Info, key.c_str(), values);
+        std::string line = key + ": [";
+        for (size_t i = 0; i < values.size(); ++i) {
+            line += std::to_string(values[i]);
+            if (i != values.size() - 1)
+                line += ", ";
         }
+        line += "]\n";
+        push(line, admit(key.c_str()));
     }
 
     // Log all key-value pairs in a map (map<string, string>)
     static void log(const std::map<std::string, std::string>& keyValuePairs) {
-        if (!logging)
+        if (!enabled(LogLevel::Info))
             return;
-        std::lock_guard<std::mutex> lock(fileMutex);  // Thread-safe access
-        std::ofstream file(filePath, std::ios::app);
-        if (file.is_open()) {
+        if (binary) {
             for (const auto& pair : keyValuePairs) {
-                file << pair.first << ": " << pair.second << std::endl;
+                log(LogLevel::Info, pair.first.c_str(), pair.second);
             }
+            return;
+        }
+        std::string lines;  // Every pair, for the tail
+        std::string kept;   // The pairs their keys' limits let through, as one record so they stay together
+        for (const auto& pair : keyValuePairs) {
+            size_t start = lines.size();
+            lines.append(pair.first).append(": ").append(pair.second).push_back('\n');
+            if (admit(pair.first.c_str()))
+                kept.append(lines, start, std::string::npos);
         }
+        tail.pushLines(lines.data(), lines.size());
+        if (!kept.empty())
+            enqueue(kept);
     }
 
-    static void printLastLine(WINDOW* win) {
-        if (!logging)
+    // Blocks until every record logged before the call has been written to the file
+    static void flush() {
+        if (!started)
             return;
-        std::ifstream file(filePath, std::ios::in | std::ios::ate);  // Open at end of file
-        std::string lastLine;
-
-        if (file.is_open()) {
-            // Start reading from the end of the file
-            file.seekg(-1, std::ios::end);
-
-            // Check for a newline character or end of file
-            bool isLastLineEmpty = (file.peek() == '\n');
-            while (file.tellg() > 0) {
-                char ch;
-                file.seekg(-1, std::ios::cur);  // Move one character back
-                ch = file.get();
+        size_t target = ring.pushed();
+        std::unique_lock<std::mutex> lock(stateMutex);
+        wakeRequested = true;
+        wake.notify_one();
+        flushed.wait(lock, [target] { return written.load() >= target || !started; });
+    }
 
-                if (ch == '\n' && !isLastLineEmpty) {
-                    break;
-                }
+    // Writes everything still queued, stops the writer thread and closes the file.
+    // Runs automatically when the program exits; logging afterwards starts a new writer.
+    static void shutdown() {
+        if (!started)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            stopRequested = true;
+            wake.notify_one();
+        }
+        writer.join();
+        std::lock_guard<std::mutex> lock(stateMutex);
+        started       = false;
+        stopRequested = false;
+        flushed.notify_all();
+        std::lock_guard<std::mutex> fileLock(fileMutex);
+        closeFile();
+    }
 
-                if (ch != '\n') {
-                    lastLine.insert(lastLine.begin(), ch);  // Insert character at the beginning
-                    file.seekg(-1, std::ios::cur);
-                }
-                isLastLineEmpty = false;
+    // The newest k lines logged, oldest first, for a log panel
+    static std::vector<std::string> lastLines(size_t k) {
+        std::vector<bool> isBinary;
+        std::vector<std::string> lines = tail.last(k, &isBinary);
+        for (size_t i = 0; i < lines.size(); ++i) {
+            if (isBinary[i]) {
+                std::string text;
+                describe(lines[i].data(), lines[i].size(), text);
+                lines[i].swap(text);
             }
-            file.close();
-        } else {
-            std::cerr << "Unable to open file: " << filePath << std::endl;
         }
+        return lines;
+    }
+
+    // Draws the newest line on the top row of win. Reads the in-memory tail, not the file, and
+    // allocates nothing in text mode, since the dice animation calls it on every frame.
+    static void printLastLine(WINDOW* win) {
+        if (!enabled(LogLevel::Error))
+            return;
+        char lastLine[LogTail::lineText + 1];
+        bool isBinary = false;
+        size_t length = tail.copyLast(lastLine, sizeof(lastLine), &isBinary);
         int h, w;  // height and width of window
         getmaxyx(win, h, w);
         mvwprintw(win, 0, 0, "%-*s", w, " ");  // blank out entire top line
-        mvwprintw(win, 0, 0, lastLine.c_str());
+        if (isBinary) {
+            static thread_local std::string text;  // Reused, so decoding only allocates while it grows
+            text.clear();
+            describe(lastLine, length, text);
+            mvwprintw(win, 0, 0, "%s", text.c_str());
+        } else if (length != 0) {
+            mvwprintw(win, 0, 0, "%s", lastLine);
+        }
         return;
     }
 
+    // Fills win with the newest lines, one per row, the newest at the bottom
+    static void printLastLines(WINDOW* win) {
+        if (!enabled(LogLevel::Error))
+            return;
+        int h, w;  // height and width of window
+        getmaxyx(win, h, w);
+        std::vector<std::string> lines = lastLines((size_t)h);
+        int first                      = h - (int)lines.size();  // Rows above the oldest line stay blank
+        for (int row = 0; row < h; ++row) {
+            wmove(win, row, 0);
+            wclrtoeol(win);
+            if (row >= first)
+                mvwaddnstr(win, row, 0, lines[row - first].c_str(), w);
+        }
+    }
+
    private:
     static std::string filePath;
-    static std::mutex fileMutex;  // Mutex to ensure thread-safe file writing
-    static bool logging;
+    static std::mutex fileMutex;  // Guards fd and filePath while the file is opened, written or closed
+    static std::atomic<int> threshold;  // Lowest level logged at run time
+
+    static int fd;                            // Log file, opened in append mode on first write
+    static LogRing ring;                      // Records waiting for the writer thread
+    static LogTail tail;                      // Newest lines, for drawing on screen
+    static std::atomic<bool> draining;        // Held by whoever is popping the ring
+    static std::atomic<size_t> written;       // Records written so far
+    static std::thread writer;                // Background thread running writerLoop
+    static std::mutex stateMutex;             // Guards started and the wake/stop flags
+    static std::condition_variable wake;      // Wakes the writer early
+    static std::condition_variable flushed;   // Signalled after every batch
+    static std::atomic<bool> started;         // The writer thread is running
+    static bool wakeRequested;
+    static bool stopRequested;
+    static std::atomic<bool> binary;          // Write binary records instead of text
+    static const size_t maxKeys = 4096;       // Keys given ids; any more are written inline
+    static std::string keyNames[maxKeys];     // Name of key id i + 1, never changed once set
+    static std::atomic<size_t> keyCount;      // Ids handed out so far
+    static std::unordered_map<std::string, uint32_t> keyIds;
+    static std::mutex keyMutex;               // Guards keyIds and handing out ids
+    static std::chrono::steady_clock::time_point startTime;
+    // Rate limit and sampling state for one key. Set up once and never removed, so the hot
+    // path can read the table without a lock.
+    struct KeyLimit {
+        std::string key;
+        std::atomic<unsigned> everyN;       // Sampling: write 1 record in everyN (0 or 1: all)
+        std::atomic<unsigned> perSecond;    // Rate limit (0: none)
+        std::atomic<uint64_t> seen;         // Records logged with this key
+        std::atomic<uint64_t> second;       // Second that inSecond counts for
+        std::atomic<unsigned> inSecond;     // Records written during that second
+        std::atomic<uint64_t> suppressed;   // Held back since the last report
+    };
+    static const size_t maxLimits = 32;
+    static KeyLimit limits[maxLimits];
+    static std::atomic<size_t> limitCount;
+    static std::mutex limitMutex;            // Guards adding to limits
+    static std::atomic<size_t> rotateBytes;  // 0: never rotate
+    static unsigned keepFiles;               // Old logs kept by rotate (guarded by fileMutex)
+    static size_t fileSize;                  // Bytes in the open file (guarded by fileMutex)
+    static size_t headerSize;                // Bytes of it that are the binary header
+    static const int crashSignals[6];
+    static struct sigaction previousActions[6];
+
+    // Queues one formatted record, starting the writer on first use. If the ring is full the
+    // caller waits for the writer to make room rather than dropping the record. Records a
+    // limit held back only go to the tail.
+    static void push(const std::string& record, bool toFile = true) {
+        tail.pushLines(record.data(), record.size());
+        if (toFile)
+            enqueue(record);
+    }
+
+    static void enqueue(const std::string& record) {
+        start();
+        while (!ring.tryPush(record.data(), record.size())) {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            wakeRequested = true;  // Without this the writer would sleep out its timeout
+            wake.notify_one();
+            lock.unlock();
+            std::this_thread::yield();
+        }
+    }
+
+    static void pushBinary(const std::string& record, bool toFile) {
+        tail.push(record.data(), record.size(), true);
+        if (toFile)
+            enqueue(record);
+    }
+
+    // The limit for key, added if it has none yet. nullptr once the table is full: handing out
+    // another key's entry would limit both keys together.
+    static KeyLimit* keyLimit(const char* key) {
+        std::lock_guard<std::mutex> lock(limitMutex);
+        size_t count = limitCount.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            if (limits[i].key == key)
+                return &limits[i];
+        }
+        if (count == maxLimits)
+            return nullptr;
+        limits[count].key = key;
+        limitCount.store(count + 1, std::memory_order_release);
+        return &limits[count];
+    }
+
+    // Whether a record with this key goes to the file. With no limits set this is one load.
+    static bool admit(const char* key) {
+        size_t count = limitCount.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            KeyLimit& limit = limits[i];
+            if (std::strcmp(limit.key.c_str(), key) != 0)
+                continue;
+            uint64_t seen  = limit.seen.fetch_add(1, std::memory_order_relaxed);
+            unsigned every = limit.everyN.load(std::memory_order_relaxed);
+            if (every > 1 && seen % every != 0) {
+                limit.suppressed.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            unsigned rate = limit.perSecond.load(std::memory_order_relaxed);
+            if (rate != 0) {
+                uint64_t second  = now() / 1000000;
+                uint64_t current = limit.second.load(std::memory_order_relaxed);
+                if (second != current && limit.second.compare_exchange_strong(current, second, std::memory_order_relaxed))
+                    limit.inSecond.store(0, std::memory_order_relaxed);
+                if (limit.inSecond.fetch_add(1, std::memory_order_relaxed) >= rate) {
+                    limit.suppressed.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            }
+            return true;
+        }
+        return true;
+    }
+
+    // Appends a "suppressed: [key, n]" record to batch for every key that held records back
+    // since the last report. The key is written inline in binary mode: registering it would
+    // push into the ring, which the writer thread must never wait on.
+    static void reportSuppressed(std::string& batch) {
+        size_t count = limitCount.load(std::memory_order_acquire);
+        std::string record;
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t suppressed = limits[i].suppressed.exchange(0, std::memory_order_relaxed);
+            if (suppressed == 0)
+                continue;
+            if (binary) {
+                LogBinary::beginData(record, (int)LogLevel::Info, now(), 0, "suppressed", 2);
+                LogBinary::putValue(record, limits[i].key);
+                LogBinary::putValue(record, suppressed);
+                LogBinary::endRecord(record);
+            } else {
+                record.assign("suppressed: [").append(limits[i].key).append(", ");
+                appendValue(record, suppressed);
+                record.append("]\n");
+            }
+            batch.append(record);
+        }
+        writeBatch(batch);
+    }
+
+    static uint64_t now() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime)
+            .count();
+    }
+
+    // The id of a key, or 0 if the table is full. Each thread remembers recently used key
+    // pointers, so a string literal key is usually found without taking keyMutex.
+    static uint32_t keyId(const char* key) {
+        struct Cached {
+            const char* pointer;
+            uint32_t id;
+        };
+        static thread_local Cached cache[64];
+        Cached& cached = cache[((uintptr_t)key >> 3) & 63];
+        if (cached.pointer == key && cached.id != 0 && std::strcmp(keyNames[cached.id - 1].c_str(), key) == 0)
+            return cached.id;
+        uint32_t id    = registerKey(key);
+        cached.pointer = key;
+        cached.id      = id;
+        return id;
+    }
+
+    // Gives key an id and queues its key record. The record is pushed while keyMutex is held,
+    // so it reaches the ring before any record that uses the id.
+    static uint32_t registerKey(const char* key) {
+        std::lock_guard<std::mutex> lock(keyMutex);
+        std::unordered_map<std::string, uint32_t>::const_iterator found = keyIds.find(key);
+        if (found != keyIds.end())
+            return found->second;
+        size_t count = keyCount.load(std::memory_order_relaxed);
+        if (count == maxKeys)
+            return 0;
+        uint32_t id     = (uint32_t)count + 1;
+        keyNames[count] = key;
+        keyCount.store(count + 1, std::memory_order_release);
+        keyIds[key] = id;
+        std::string record;
+        LogBinary::keyRecord(record, id, key);
+        enqueue(record);
+        return id;
+    }
+
+    // Appends the text of a binary record kept in the tail to text
+    static void describe(const char* record, size_t length, std::string& text) {
+        static thread_local LogBinary::Record decoded;
+        if (!LogBinary::readRecord(record, record + length, decoded)) {
+            text.append("(record too long to show)");
+            return;
+        }
+        bool named = decoded.key != 0 && decoded.key <= keyCount.load(std::memory_order_acquire);
+        LogBinary::formatText(decoded, named ? keyNames[decoded.key - 1] : decoded.name, text);
+    }
+
+    // The magic and every key handed out so far, at the start of a binary file. Uses only
+    // write() and stack buffers, so the crash handler can call it too.
+    static void writeHeader() {
+        writeAll(fd, LogBinary::magic(), LogBinary::magicSize);
+        size_t count = keyCount.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const std::string& name = keyNames[i];
+            char body[24];
+            size_t length = 0;
+            body[length++] = (char)LogBinary::KeyRecord;
+            length += LogBinary::varint(body + length, i + 1);
+            length += LogBinary::varint(body + length, name.size());
+            char prefix[10];
+            size_t prefixLength = LogBinary::varint(prefix, length + name.size());
+            writeAll(fd, prefix, prefixLength);
+            writeAll(fd, body, length);
+            writeAll(fd, name.data(), name.size());
+        }
+    }
+
+    static void putValues(std::string&) {}
+
+    template <typename T, typename... Rest>
+    static void putValues(std::string& record, const T& value, const Rest&... rest) {
+        LogBinary::putValue(record, value);
+        putValues(record, rest...);
+    }
+
+    static std::string& lineBuffer() {
+        static thread_local std::string line;
+        return line;
+    }
+
+    static void appendValues(std::string&) {}
+
+    template <typename T>
+    static void appendValues(std::string& line, const T& value) {
+        appendValue(line, value);
+    }
+
+    template <typename T, typename... Rest>
+    static void appendValues(std::string& line, const T& first, const Rest&... rest) {
+        line.push_back('[');
+        appendValue(line, first);
+        appendList(line, rest...);
+        line.push_back(']');
+    }
+
+    static void appendList(std::string&) {}
+
+    template <typename T, typename... Rest>
+    static void appendList(std::string& line, const T& value, const Rest&... rest) {
+        line.append(", ");
+        appendValue(line, value);
+        appendList(line, rest...);
+    }
+
+    static void appendValue(std::string& line, const std::string& value) { line.append(value); }
+    static void appendValue(std::string& line, const char* value) { line.append(value ? value : "(null)"); }
+    static void appendValue(std::string& line, char value) { line.push_back(value); }
+    static void appendValue(std::string& line, bool value) { line.append(value ? "true" : "false"); }
+
+    static void appendValue(std::string& line, double value) {
+        char digits[32];
+        int length = snprintf(digits, sizeof(digits), "%g", value);
+        line.append(digits, length > 0 ? (size_t)length : 0);
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value>::type appendValue(std::string& line, T value) {
+        char digits[24];  // Filled from the end
+        char* end   = digits + sizeof(digits);
+        char* begin = end;
+        typedef typename std::make_unsigned<T>::type U;
+        U magnitude = value < 0 ? (U)(0 - (U)value) : (U)value;  // Safe for the most negative value
+        do {
+            *--begin = (char)('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (value < 0)
+            *--begin = '-';
+        line.append(begin, (size_t)(end - begin));
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type appendValue(std::string& line, T value) {
+        appendValue(line, (double)value);
+    }
+
+    template <typename T>
+    static void appendValue(std::string& line, const std::vector<T>& values) {
+        line.push_back('[');
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (i != 0)
+                line.append(", ");
+            appendValue(line, values[i]);
+        }
+        line.push_back(']');
+    }
+
+    static void start() {
+        if (started)
+            return;
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (started)
+            return;
+        static bool handlersInstalled = false;
+        if (!handlersInstalled) {
+            installCrashHandlers();
+            handlersInstalled = true;
+        }
+        writer  = std::thread(writerLoop);
+        started = true;
+    }
+
+    static void writerLoop() {
+        std::string batch;
+        batch.reserve(1 << 16);
+        uint64_t lastReport = now();
+        std::unique_lock<std::mutex> lock(stateMutex);
+        while (true) {
+            bool stopping = stopRequested;
+            wakeRequested = false;
+            lock.unlock();
+            drain(batch);
+            if (stopping || now() - lastReport >= 1000000) {
+                reportSuppressed(batch);
+                lastReport = now();
+            }
+            lock.lock();
+            flushed.notify_all();
+            if (stopping) {
+                if (written.load() == ring.pushed())
+                    break;
+                continue;  // A record was claimed but not copied in yet
+            }
+            wake.wait_for(lock, std::chrono::milliseconds(20), [] { return wakeRequested || stopRequested; });
+        }
+    }
+
+    // Pops every published record and appends them to the file in as few writes as possible
+    static void drain(std::string& batch) {
+        while (draining.exchange(true, std::memory_order_acquire))
+            std::this_thread::yield();
+        size_t count = 0;
+        size_t limit = batchLimit();
+        const LogRing::Slot* slot;
+        while ((slot = ring.front()) != nullptr) {
+            if (!batch.empty() && batch.size() + slot->length > limit) {
+                writeBatch(batch);  // Keeps each batch within the rotation size
+            }
+            batch.append(LogRing::textOf(slot), slot->length);
+            ring.pop();
+            ++count;
+        }
+        writeBatch(batch);
+        written += count;
+        draining.store(false, std::memory_order_release);
+    }
+
+    // Batches are written before they pass 64KB, or half the rotation size if that is smaller
+    // (leaving room for the header a new binary file starts with)
+    static size_t batchLimit() {
+        size_t limit = rotateBytes.load(std::memory_order_relaxed) / 2;
+        return limit != 0 && limit < (1 << 16) ? limit : (1 << 16);
+    }
+
+    static void writeBatch(std::string& batch) {
+        if (batch.empty())
+            return;
+        std::lock_guard<std::mutex> lock(fileMutex);
+        size_t limit = rotateBytes.load(std::memory_order_relaxed);
+        if (openFile() && limit != 0 && fileSize > headerSize && fileSize + batch.size() > limit)
+            rotate();
+        if (fd >= 0) {
+            writeAll(fd, batch.data(), batch.size());
+            fileSize += batch.size();
+        }
+        batch.clear();
+    }
+
+    // Shifts path.1 ... path.<keep - 1> up by one, moves the current log to path.1 and starts
+    // an empty one. Called with fileMutex held.
+    static void rotate() {
+        closeFile();
+        for (unsigned i = keepFiles; i > 1; --i) {
+            std::string older = filePath + "." + std::to_string(i - 1);
+            ::rename(older.c_str(), (filePath + "." + std::to_string(i)).c_str());
+        }
+        if (keepFiles > 0)
+            ::rename(filePath.c_str(), (filePath + ".1").c_str());
+        else
+            ::unlink(filePath.c_str());
+        openFile();
+    }
+
+    static bool openFile() {
+        if (fd >= 0)
+            return true;
+        fd = ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        struct stat status;
+        headerSize = 0;
+        if (fd >= 0 && fstat(fd, &status) == 0) {
+            fileSize = (size_t)status.st_size;
+            if (binary && fileSize == 0) {
+                writeHeader();
+                if (fstat(fd, &status) == 0)
+                    headerSize = fileSize = (size_t)status.st_size;
+            }
+        }
+        return fd >= 0;
+    }
+
+    static void closeFile() {
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+    }
+
+    static void writeAll(int file, const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t done = ::write(file, data, size);
+            if (done < 0 && errno == EINTR)
+                continue;
+            if (done <= 0)
+                return;
+            data += done;
+            size -= (size_t)done;
+        }
+    }
+
+    static void installCrashHandlers() {
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        action.sa_handler = crashHandler;
+        sigemptyset(&action.sa_mask);
+        for (int i = 0; i < 6; ++i) {
+            sigaction(crashSignals[i], &action, &previousActions[i]);
+        }
+    }
+
+    // Writes out whatever is still in the ring with plain write() calls, then hands the signal
+    // to whatever handled it before the Logger. Nothing here locks, allocates or frees: the
+    // records are taken with ring.skip(), which leaks the heap text of overlong records
+    // rather than calling free() inside a signal handler.
+    static void crashHandler(int sig) {
+        bool acquired = false;
+        for (int spin = 0; spin < (1 << 20) && !acquired; ++spin) {
+            acquired = !draining.exchange(true, std::memory_order_acquire);  // Gives up if the crashed thread held it
+        }
+        if (acquired) {
+            openFile();
+            size_t count = 0;
+            const LogRing::Slot* slot;
+            while ((slot = ring.front()) != nullptr) {
+                if (fd >= 0)
+                    writeAll(fd, LogRing::textOf(slot), slot->length);
+                ring.skip();
+                ++count;
+            }
+            written += count;  // In case the previous handler returns and the program carries on
+            draining.store(false, std::memory_order_release);
+        }
+        for (int i = 0; i < 6; ++i) {
+            if (crashSignals[i] == sig)
+                sigaction(sig, &previousActions[i], nullptr);
+        }
+        raise(sig);
+    }
 };
 
 // Define the static member variables
 std::string Logger::filePath = "log.txt";
 std::mutex Logger::fileMutex;
-bool Logger::logging = true;
\ No newline at end of file
+std::atomic<int> Logger::threshold((int)LogLevel::Trace);
+int Logger::fd = -1;
+LogRing Logger::ring(4096);
+LogTail Logger::tail(64);
+std::atomic<bool> Logger::draining(false);
+std::atomic<size_t> Logger::written(0);
+std::thread Logger::writer;
+std::mutex Logger::stateMutex;
+std::condition_variable Logger::wake;
+std::condition_variable Logger::flushed;
+std::atomic<bool> Logger::started(false);
+bool Logger::wakeRequested = false;
+bool Logger::stopRequested = false;
+std::atomic<bool> Logger::binary(false);
+std::string Logger::keyNames[Logger::maxKeys];
+std::atomic<size_t> Logger::keyCount(0);
+std::unordered_map<std::string, uint32_t> Logger::keyIds;
+std::mutex Logger::keyMutex;
+std::chrono::steady_clock::time_point Logger::startTime = std::chrono::steady_clock::now();
+Logger::KeyLimit Logger::limits[Logger::maxLimits];
+std::atomic<size_t> Logger::limitCount(0);
+std::mutex Logger::limitMutex;
+std::atomic<size_t> Logger::rotateBytes(0);
+unsigned Logger::keepFiles = 0;
+size_t Logger::fileSize    = 0;
+size_t Logger::headerSize  = 0;
+const int Logger::crashSignals[6] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT, SIGTERM};
+struct sigaction Logger::previousActions[6];
+
+// Destroyed before the members above, so the writer thread is joined and the ring written
+// out while everything it uses still exists
+struct LoggerShutdown {
+    ~LoggerShutdown() { Logger::shutdown(); }
+};
+LoggerShutdown loggerShutdown;